@@ -0,0 +1,207 @@
+/*
+ *  Fila de admissão dos lotes cheios.
+ *
+ *  Uma fila circular por lote, cada uma com a própria trava. A tarefa de
+ *  entrada enfileira e a de saída admite a cabeça, então decidir "entra
+ *  direto ou vai para a fila" e "retira a cabeça e ocupa a vaga" acontecem
+ *  com a trava do lote (alguns CAS do estacionamento): um carro novo nunca
+ *  passa na frente de quem já espera. Pistas de lotes diferentes não
+ *  disputam a mesma trava. Como todos esperam o mesmo tempo máximo, os
+ *  expirados estão sempre na cabeça e saem antes de cada decisão.
+ *
+ *  A vaga do mapa (vagas.c) é ocupada ou liberada com a mesma trava, logo
+ *  depois do CAS que muda a ocupação do lote, na entrada, na saída e no
+ *  reset. A ocupação continua só no contador do estacionamento. A trava faz
+ *  o mapa acompanhar o contador, mesmo com a entrada e a saída do mesmo
+ *  lote em núcleos diferentes.
+ */
+
+#include <string.h>
+
+#include "pico/critical_section.h"
+#include "pico/stdlib.h"
+
+#include "admissao.h"
+#include "estacionamento.h"
+#include "vagas.h"
+
+#define ADMISSAO_ESPERA_US ((uint32_t)ADMISSAO_ESPERA_MS * 1000u)
+
+typedef struct {
+    critical_section_t trava;       // Fila, ocupação e vagas deste lote
+    admissao_carro_t carros[ADMISSAO_MAX];
+    uint8_t cabeca;
+    uint8_t tamanho;
+    uint32_t admitidos;
+    uint32_t expirados;
+    bool houve_saida;
+    uint32_t ultima_saida_us;
+    uint32_t intervalo_us;          // 0 até a segunda saída
+} fila_lote_t;
+
+static fila_lote_t filas[EST_MAX_LOTES];
+
+
+void admissao_init(void) {
+    memset(filas, 0, sizeof(filas));
+    for (size_t i = 0; i < EST_MAX_LOTES; i++) {
+        critical_section_init(&filas[i].trava);
+    }
+}
+
+
+// Chamado com a trava do lote
+static void descarta_expirados(fila_lote_t *f, uint32_t agora_us) {
+    while (f->tamanho &&
+           agora_us - f->carros[f->cabeca].chegada_us >= ADMISSAO_ESPERA_US) {
+        f->cabeca = (f->cabeca + 1) % ADMISSAO_MAX;
+        f->tamanho--;
+        f->expirados++;
+    }
+}
+
+
+// Carro na cancela de entrada: entra se há vaga e fila vazia (e recebe a
+// vaga do mapa), senão espera na fila (posição a partir de 1) ou é recusado
+// com a fila cheia
+admissao_resultado_t admissao_chega(uint8_t lote, const admissao_carro_t *carro,
+                                    uint16_t *ocupadas, int16_t *vaga, uint8_t *posicao) {
+    fila_lote_t *f = &filas[lote];
+    admissao_resultado_t resultado;
+
+    critical_section_enter_blocking(&f->trava);
+    descarta_expirados(f, carro->chegada_us);
+    if (f->tamanho == 0 && estacionamento_entra(lote, ocupadas)) {
+        *vaga = vagas_ocupa(lote);
+        resultado = ADMISSAO_ENTROU;
+    } else if (f->tamanho < ADMISSAO_MAX) {
+        f->carros[(f->cabeca + f->tamanho) % ADMISSAO_MAX] = *carro;
+        *posicao = ++f->tamanho;
+        resultado = ADMISSAO_NA_FILA;
+    } else {
+        resultado = ADMISSAO_LOTADO;
+    }
+    critical_section_exit(&f->trava);
+
+    return resultado;
+}
+
+
+// Carro na cancela de saída: libera a vaga ocupada há mais tempo e atualiza
+// a média do intervalo entre saídas. Falso com o lote já vazio.
+bool admissao_saida(uint8_t lote, uint32_t agora_us, uint16_t *ocupadas) {
+    fila_lote_t *f = &filas[lote];
+
+    critical_section_enter_blocking(&f->trava);
+    if (!estacionamento_sai(lote, ocupadas)) {
+        critical_section_exit(&f->trava);
+        return false;
+    }
+    vagas_libera(lote);
+    if (f->houve_saida) {
+        uint32_t amostra = agora_us - f->ultima_saida_us;
+        if (amostra > ADMISSAO_INTERVALO_MAX_MS * 1000u) {
+            amostra = ADMISSAO_INTERVALO_MAX_MS * 1000u;
+        }
+        if (f->intervalo_us == 0) {
+            f->intervalo_us = amostra;
+        } else {
+            f->intervalo_us += ((int32_t)(amostra - f->intervalo_us)) >> ADMISSAO_EWMA_SHIFT;
+        }
+    }
+    f->houve_saida = true;
+    f->ultima_saida_us = agora_us;
+    critical_section_exit(&f->trava);
+    return true;
+}
+
+
+// Ocupa a vaga livre com o primeiro da fila. Falso com a fila vazia ou sem
+// vaga.
+bool admissao_admite(uint8_t lote, uint32_t agora_us, admissao_carro_t *carro, uint16_t *ocupadas,
+                     int16_t *vaga) {
+    fila_lote_t *f = &filas[lote];
+    bool admitido = false;
+
+    critical_section_enter_blocking(&f->trava);
+    descarta_expirados(f, agora_us);
+    if (f->tamanho && estacionamento_entra(lote, ocupadas)) {
+        *vaga = vagas_ocupa(lote);
+        *carro = f->carros[f->cabeca];
+        f->cabeca = (f->cabeca + 1) % ADMISSAO_MAX;
+        f->tamanho--;
+        f->admitidos++;
+        admitido = true;
+    }
+    critical_section_exit(&f->trava);
+
+    return admitido;
+}
+
+
+// Espera estimada de quem está na posição dada: uma saída por intervalo médio
+uint32_t admissao_espera_ms(uint8_t lote, uint8_t posicao) {
+    uint32_t intervalo_us = filas[lote].intervalo_us;
+
+    if (intervalo_us == 0) return ADMISSAO_SEM_ESTIMATIVA;
+    return (uint32_t)(((uint64_t)intervalo_us * posicao) / 1000u);
+}
+
+
+// Todas as filas se desfazem
+void admissao_limpa(void) {
+    for (size_t i = 0; i < EST_MAX_LOTES; i++) {
+        critical_section_enter_blocking(&filas[i].trava);
+        filas[i].tamanho = 0;
+        critical_section_exit(&filas[i].trava);
+    }
+}
+
+
+// Reset do estacionamento: fila, ocupação e vagas de cada lote, um lote
+// por vez (as travas nunca se aninham)
+void admissao_esvazia(void) {
+    for (size_t i = 0; i < estacionamento_num_lotes(); i++) {
+        critical_section_enter_blocking(&filas[i].trava);
+        filas[i].tamanho = 0;
+        estacionamento_define((uint8_t)i, 0);
+        vagas_limpa((uint8_t)i);
+        critical_section_exit(&filas[i].trava);
+    }
+}
+
+
+// Descarta quem desistiu em todos os lotes, sem esperar a próxima entrada
+// ou saída. Verdadeiro se alguma fila mudou; 'esperando' recebe quantos
+// carros ainda estão nas filas.
+bool admissao_expira(uint32_t agora_us, uint16_t *esperando) {
+    bool mudou = false;
+
+    *esperando = 0;
+    for (size_t i = 0; i < estacionamento_num_lotes(); i++) {
+        fila_lote_t *f = &filas[i];
+
+        critical_section_enter_blocking(&f->trava);
+        uint8_t antes = f->tamanho;
+        descarta_expirados(f, agora_us);
+        mudou |= f->tamanho != antes;
+        *esperando += f->tamanho;
+        critical_section_exit(&f->trava);
+    }
+    return mudou;
+}
+
+
+// Fila já sem os expirados, para o display e a rede nunca mostrarem quem
+// desistiu
+void admissao_resumo(uint8_t lote, admissao_resumo_t *out) {
+    fila_lote_t *f = &filas[lote];
+
+    critical_section_enter_blocking(&f->trava);
+    descarta_expirados(f, time_us_32());
+    out->tamanho = f->tamanho;
+    out->admitidos = f->admitidos;
+    out->expirados = f->expirados;
+    out->intervalo_ms = f->intervalo_us ? f->intervalo_us / 1000u : ADMISSAO_SEM_ESTIMATIVA;
+    critical_section_exit(&f->trava);
+}
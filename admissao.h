@@ -0,0 +1,52 @@
+#ifndef ADMISSAO_H
+#define ADMISSAO_H
+
+// Fila de admissão por lote: com o lote cheio o carro espera na fila, em
+// ordem de chegada, e entra sozinho quando uma saída libera a vaga. Quem
+// espera mais que ADMISSAO_ESPERA_MS desiste. A espera estimada vem de uma
+// média móvel exponencial do intervalo entre saídas, atualizada a cada saída.
+// Entradas, saídas e o reset passam por aqui para que a ocupação do lote e a
+// vaga do carro mudem juntas, com a trava daquele lote.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ADMISSAO_MAX 8                  // Carros esperando por lote
+#define ADMISSAO_ESPERA_MS 180000       // Desistência
+#define ADMISSAO_EWMA_SHIFT 3           // Peso 1/8 para cada intervalo novo
+#define ADMISSAO_INTERVALO_MAX_MS 600000 // Limite de uma amostra (lote parado)
+#define ADMISSAO_VARREDURA_MS 1000      // Desistências sem tráfego (admissao_expira)
+#define ADMISSAO_SEM_ESTIMATIVA UINT32_MAX
+
+typedef enum {
+    ADMISSAO_ENTROU,                    // Havia vaga e ninguém na frente
+    ADMISSAO_NA_FILA,
+    ADMISSAO_LOTADO,                    // Fila cheia: entrada recusada
+} admissao_resultado_t;
+
+typedef struct {
+    uint32_t chegada_us;
+    uint8_t pista;
+} admissao_carro_t;
+
+typedef struct {
+    uint8_t tamanho;
+    uint32_t admitidos;                 // Entraram pela fila
+    uint32_t expirados;                 // Desistiram
+    uint32_t intervalo_ms;              // Média entre saídas (ADMISSAO_SEM_ESTIMATIVA)
+} admissao_resumo_t;
+
+void admissao_init(void);
+admissao_resultado_t admissao_chega(uint8_t lote, const admissao_carro_t *carro,
+                                    uint16_t *ocupadas, int16_t *vaga, uint8_t *posicao);
+bool admissao_saida(uint8_t lote, uint32_t agora_us, uint16_t *ocupadas);
+bool admissao_admite(uint8_t lote, uint32_t agora_us, admissao_carro_t *carro, uint16_t *ocupadas,
+                     int16_t *vaga);
+uint32_t admissao_espera_ms(uint8_t lote, uint8_t posicao);
+void admissao_limpa(void);
+void admissao_esvazia(void);
+bool admissao_expira(uint32_t agora_us, uint16_t *esperando);
+void admissao_resumo(uint8_t lote, admissao_resumo_t *out);
+
+#endif
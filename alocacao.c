@@ -0,0 +1,87 @@
+/*
+ *  Registro das tarefas criadas por CRIA_TAREFA e relatório de memória:
+ *  pilha reservada e menor folga já vista (uxTaskGetStackHighWaterMark) de
+ *  cada tarefa, incluindo idle e timers do kernel, mais o uso do heap (ou o
+ *  total estático com CONTROLE_VAGA_ESTATICO).
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "alocacao.h"
+
+typedef struct {
+    TaskHandle_t tarefa;
+    uint32_t palavras;
+} alocacao_tarefa_t;
+
+static alocacao_tarefa_t tarefas[ALOCACAO_MAX_TAREFAS];
+static uint8_t num_tarefas;
+
+
+// Chamado na criação (antes do escalonador ou numa tarefa só)
+void alocacao_registra(TaskHandle_t tarefa, uint32_t palavras) {
+    configASSERT(tarefa != NULL);
+    if (num_tarefas < ALOCACAO_MAX_TAREFAS) {
+        tarefas[num_tarefas].tarefa = tarefa;
+        tarefas[num_tarefas].palavras = palavras;
+        num_tarefas++;
+    }
+}
+
+
+// Pilha das tarefas do kernel: a de timers tem profundidade própria, as de
+// idle usam configMINIMAL_STACK_SIZE
+static uint32_t alocacao_palavras(TaskHandle_t tarefa) {
+    for (uint8_t i = 0; i < num_tarefas; i++) {
+        if (tarefas[i].tarefa == tarefa) {
+            return tarefas[i].palavras;
+        }
+    }
+    if (tarefa == xTimerGetTimerDaemonTaskHandle()) {
+        return configTIMER_TASK_STACK_DEPTH;
+    }
+    if (strncmp(pcTaskGetName(tarefa), "IDLE", 4) == 0) {
+        return configMINIMAL_STACK_SIZE;
+    }
+    return 0;
+}
+
+
+void alocacao_relatorio(void) {
+    static TaskStatus_t estado[ALOCACAO_MAX_TAREFAS + 4];
+    UBaseType_t n = uxTaskGetSystemState(estado, count_of(estado), NULL);
+    uint32_t total = 0;
+
+    printf("tarefa          pilha (B)  folga min (B)  uso max\n");
+    for (UBaseType_t i = 0; i < n; i++) {
+        uint32_t pilha = alocacao_palavras(estado[i].xHandle) * sizeof(StackType_t);
+        uint32_t folga = estado[i].usStackHighWaterMark * sizeof(StackType_t);
+
+        total += pilha;
+        if (pilha) {
+            printf("%-15s %10lu %14lu %7lu%%\n", estado[i].pcTaskName, (unsigned long)pilha,
+                   (unsigned long)folga, (unsigned long)((pilha - folga) * 100 / pilha));
+        } else {
+            printf("%-15s %10s %14lu %8s\n", estado[i].pcTaskName, "?", (unsigned long)folga, "?");
+        }
+    }
+#if CONTROLE_VAGA_ESTATICO
+    printf("estatico: %lu B de pilhas e %lu B de TCBs, sem heap do FreeRTOS\n",
+           (unsigned long)total, (unsigned long)(n * sizeof(StaticTask_t)));
+#else
+    printf("heap: %lu B de pilhas, %lu B livres agora, minimo %lu B de %lu B\n",
+           (unsigned long)total, (unsigned long)xPortGetFreeHeapSize(),
+           (unsigned long)xPortGetMinimumEverFreeHeapSize(), (unsigned long)configTOTAL_HEAP_SIZE);
+#endif
+}
+
+
+#if configCHECK_FOR_STACK_OVERFLOW
+// A pilha estourou (checagem do kernel na troca de contexto): para tudo
+// antes que a memória vizinha vire lixo
+void vApplicationStackOverflowHook(TaskHandle_t tarefa, char *nome) {
+    panic("Estouro de pilha em %s", nome);
+}
+#endif
@@ -0,0 +1,52 @@
+#ifndef ALOCACAO_H
+#define ALOCACAO_H
+
+// Criação de tarefas, filas e timers. Com CONTROLE_VAGA_ESTATICO tudo sai de
+// memória estática (dimensionada no link, sem heap do FreeRTOS); sem a opção,
+// do heap_4. As tarefas ficam registradas com o tamanho da pilha para o
+// relatório de marca d'água (alocacao_relatorio).
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "timers.h"
+
+#define ALOCACAO_MAX_TAREFAS 12
+
+#if CONTROLE_VAGA_ESTATICO
+#define CRIA_TAREFA(handle, funcao, nome, palavras, prioridade) do {                    \
+        static StackType_t pilha_[palavras];                                            \
+        static StaticTask_t tcb_;                                                       \
+        (handle) = xTaskCreateStatic((funcao), (nome), (palavras), NULL, (prioridade),  \
+                                     pilha_, &tcb_);                                    \
+        alocacao_registra((handle), (palavras));                                        \
+    } while (0)
+
+#define CRIA_FILA(handle, tamanho, tipo) do {                                           \
+        static uint8_t area_[(tamanho) * sizeof(tipo)];                                 \
+        static StaticQueue_t fila_;                                                     \
+        (handle) = xQueueCreateStatic((tamanho), sizeof(tipo), area_, &fila_);          \
+    } while (0)
+
+#define CRIA_TIMER(handle, nome, periodo, recarga, id, callback) do {                   \
+        static StaticTimer_t timer_;                                                    \
+        (handle) = xTimerCreateStatic((nome), (periodo), (recarga), (id), (callback),   \
+                                      &timer_);                                         \
+    } while (0)
+#else
+#define CRIA_TAREFA(handle, funcao, nome, palavras, prioridade) do {                    \
+        xTaskCreate((funcao), (nome), (palavras), NULL, (prioridade), &(handle));       \
+        alocacao_registra((handle), (palavras));                                        \
+    } while (0)
+
+#define CRIA_FILA(handle, tamanho, tipo)                                                \
+        ((handle) = xQueueCreate((tamanho), sizeof(tipo)))
+
+#define CRIA_TIMER(handle, nome, periodo, recarga, id, callback)                        \
+        ((handle) = xTimerCreate((nome), (periodo), (recarga), (id), (callback)))
+#endif
+
+void alocacao_registra(TaskHandle_t tarefa, uint32_t palavras);
+void alocacao_relatorio(void);
+
+#endif
@@ -0,0 +1,274 @@
+/*
+ *  Estatísticas incrementais da ocupação.
+ *
+ *  A ocupação total é constante entre dois eventos, então cada evento soma
+ *  ocupadas * tempo decorrido ao balde do minuto atual (a integral) antes de
+ *  aplicar a mudança. Quando o minuto vira, o balde que terminou entra nas
+ *  somas corridas das janelas e o que saiu de cada janela é subtraído: a
+ *  média de qualquer janela é uma divisão. Só o pico de uma janela olha os
+ *  baldes dela, e isso acontece na consulta, nunca no evento.
+ *
+ *  A permanência pareia cada saída com a entrada mais antiga ainda no lote
+ *  (os sensores não identificam o carro). A média sai exata pela lei de
+ *  Little; a distribuição é uma aproximação.
+ */
+
+#include <string.h>
+
+#include "controle_vaga.h"
+
+typedef struct {
+    uint32_t integral;              // Ocupadas * ms dentro do minuto
+    uint16_t pico;
+    uint16_t entradas;
+    uint16_t saidas;
+} balde_t;
+
+typedef struct {
+    uint64_t integral;
+    uint32_t entradas;
+    uint32_t saidas;
+} soma_t;
+
+static const uint8_t minutos[ANALISE_JANELAS] = { 1, 15, 60 };
+
+static balde_t baldes[ANALISE_BALDES];
+static soma_t somas[ANALISE_JANELAS];       // Baldes completos de cada janela, sem o atual
+static uint8_t atual;
+static uint32_t completos;                  // Baldes completos desde a partida (satura)
+static uint64_t inicio_balde_ms;
+static uint64_t ultimo_ms;                  // Até onde a integral já foi somada
+static uint16_t ocupadas;
+static uint16_t pico_total;
+
+static uint32_t entradas_ms[EST_MAX_LOTES][ANALISE_ESTADIAS];
+static uint8_t mais_antiga[EST_MAX_LOTES];
+static uint8_t lembradas[EST_MAX_LOTES];
+static uint32_t estadias, sem_entrada;
+static uint32_t faixas[ANALISE_FAIXAS];
+
+#if !CONTROLE_VAGA_METRICAS
+static void vTaskAnalise(void *params);
+#endif
+
+
+static uint64_t agora_ms(void) {
+    return time_us_64() / 1000u;
+}
+
+
+void analise_init(void) {
+    uint16_t capacidade;
+    uint64_t agora = agora_ms();
+
+    memset(baldes, 0, sizeof(baldes));
+    memset(somas, 0, sizeof(somas));
+    atual = 0;
+    completos = 0;
+    inicio_balde_ms = ultimo_ms = agora;
+    ocupadas = pico_total = estacionamento_total(&capacidade);
+    baldes[0].pico = ocupadas;
+
+#if !CONTROLE_VAGA_METRICAS
+    // Com as métricas ligadas a MetricasTask já lê o stdio e repassa a tecla
+    TaskHandle_t tarefa;
+    CRIA_TAREFA(tarefa, vTaskAnalise, "AnaliseTask", configMINIMAL_STACK_SIZE + 256, tskIDLE_PRIORITY);
+#endif
+}
+
+
+// As funções abaixo rodam com a seção crítica ativa
+
+static void acumula(uint64_t ate_ms) {
+    baldes[atual].integral += (uint32_t)ocupadas * (uint32_t)(ate_ms - ultimo_ms);
+    ultimo_ms = ate_ms;
+}
+
+// Fecha o balde atual e abre o próximo, atualizando as somas das janelas
+static void gira(void) {
+    const balde_t *fechado = &baldes[atual];
+    uint8_t proximo = (atual + 1) % ANALISE_BALDES;
+
+    for (size_t j = 0; j < ANALISE_JANELAS; j++) {
+        if (minutos[j] < 2) continue;
+        const balde_t *saindo = &baldes[(proximo + ANALISE_BALDES - minutos[j]) % ANALISE_BALDES];
+        somas[j].integral += fechado->integral;
+        somas[j].integral -= saindo->integral;
+        somas[j].entradas += fechado->entradas - saindo->entradas;
+        somas[j].saidas += fechado->saidas - saindo->saidas;
+    }
+
+    baldes[proximo] = (balde_t){ .pico = ocupadas };
+    atual = proximo;
+    if (completos < ANALISE_BALDES) completos++;
+}
+
+// Fecha os minutos que já terminaram. Depois de uma hora parada todos os
+// baldes ficam iguais, então o resto do intervalo é só pulado.
+static void avanca(uint64_t agora) {
+    uint64_t viradas = (agora - inicio_balde_ms) / ANALISE_BALDE_MS;
+
+    for (uint64_t i = 0; i < viradas && i < ANALISE_BALDES; i++) {
+        inicio_balde_ms += ANALISE_BALDE_MS;
+        acumula(inicio_balde_ms);
+        gira();
+    }
+    if (viradas > ANALISE_BALDES) {
+        inicio_balde_ms += (viradas - ANALISE_BALDES) * ANALISE_BALDE_MS;
+        ultimo_ms = inicio_balde_ms;
+    }
+}
+
+static void atualiza_ocupacao(uint64_t agora) {
+    uint16_t capacidade;
+
+    avanca(agora);
+    acumula(agora);
+    ocupadas = estacionamento_total(&capacidade);
+    if (ocupadas > baldes[atual].pico) baldes[atual].pico = ocupadas;
+    if (ocupadas > pico_total) pico_total = ocupadas;
+}
+
+
+// Chamado depois de a vaga ser ocupada (direto ou pela fila de admissão)
+void analise_entrada(uint8_t lote) {
+    uint64_t agora = agora_ms();
+
+    taskENTER_CRITICAL();
+    atualiza_ocupacao(agora);
+    baldes[atual].entradas++;
+
+    // Anel cheio: a entrada mais antiga é esquecida
+    if (lembradas[lote] == ANALISE_ESTADIAS) {
+        mais_antiga[lote] = (mais_antiga[lote] + 1) % ANALISE_ESTADIAS;
+        lembradas[lote]--;
+    }
+    entradas_ms[lote][(mais_antiga[lote] + lembradas[lote]) % ANALISE_ESTADIAS] = (uint32_t)agora;
+    lembradas[lote]++;
+    taskEXIT_CRITICAL();
+}
+
+
+void analise_saida(uint8_t lote) {
+    uint64_t agora = agora_ms();
+
+    taskENTER_CRITICAL();
+    atualiza_ocupacao(agora);
+    baldes[atual].saidas++;
+
+    if (lembradas[lote]) {
+        uint32_t s = ((uint32_t)agora - entradas_ms[lote][mais_antiga[lote]]) / 1000u;
+        uint faixa = s ? 32 - __builtin_clz(s) : 0;
+        if (faixa >= ANALISE_FAIXAS) faixa = ANALISE_FAIXAS - 1;
+        faixas[faixa]++;
+        estadias++;
+        mais_antiga[lote] = (mais_antiga[lote] + 1) % ANALISE_ESTADIAS;
+        lembradas[lote]--;
+    } else {
+        sem_entrada++;
+    }
+    taskEXIT_CRITICAL();
+}
+
+
+// Os lotes foram esvaziados: não há mais entradas para parear
+void analise_reset(void) {
+    uint64_t agora = agora_ms();
+
+    taskENTER_CRITICAL();
+    atualiza_ocupacao(agora);
+    memset(lembradas, 0, sizeof(lembradas));
+    taskEXIT_CRITICAL();
+}
+
+
+void analise_resumo(analise_resumo_t *out) {
+    uint64_t agora = agora_ms();
+
+    taskENTER_CRITICAL();
+    avanca(agora);
+    acumula(agora);
+
+    uint32_t parcial_ms = (uint32_t)(agora - inicio_balde_ms);
+    for (size_t j = 0; j < ANALISE_JANELAS; j++) {
+        analise_janela_t *w = &out->janelas[j];
+        uint32_t anteriores = minutos[j] - 1u < completos ? minutos[j] - 1u : completos;
+        uint64_t periodo_ms = (uint64_t)anteriores * ANALISE_BALDE_MS + parcial_ms;
+
+        w->minutos = minutos[j];
+        w->media = periodo_ms ? (float)(somas[j].integral + baldes[atual].integral) / periodo_ms : ocupadas;
+        w->entradas = somas[j].entradas + baldes[atual].entradas;
+        w->saidas = somas[j].saidas + baldes[atual].saidas;
+        w->pico = baldes[atual].pico;
+        for (uint32_t i = 1; i <= anteriores; i++) {
+            const balde_t *b = &baldes[(atual + ANALISE_BALDES - i) % ANALISE_BALDES];
+            if (b->pico > w->pico) w->pico = b->pico;
+        }
+    }
+    out->ocupadas = ocupadas;
+    out->pico_total = pico_total;
+    out->estadias = estadias;
+    out->sem_entrada = sem_entrada;
+    memcpy(out->faixas, faixas, sizeof(faixas));
+    taskEXIT_CRITICAL();
+}
+
+
+// Ocupação média (x10) de cada minuto da última hora, do mais antigo ao
+// atual (parcial). Devolve quantos minutos foram escritos.
+size_t analise_serie(uint16_t *medias_x10, size_t max) {
+    uint64_t agora = agora_ms();
+
+    taskENTER_CRITICAL();
+    avanca(agora);
+    acumula(agora);
+
+    size_t n = completos + 1 < max ? completos + 1 : max;
+    for (size_t i = 0; i < n; i++) {
+        const balde_t *b = &baldes[(atual + ANALISE_BALDES - (n - 1 - i)) % ANALISE_BALDES];
+        uint32_t periodo_ms = i == n - 1 ? (uint32_t)(agora - inicio_balde_ms) : ANALISE_BALDE_MS;
+        medias_x10[i] = periodo_ms ? (uint16_t)((uint64_t)b->integral * 10u / periodo_ms) : ocupadas * 10u;
+    }
+    taskEXIT_CRITICAL();
+    return n;
+}
+
+
+// Relatório pela USB e página com o gráfico da última hora no display
+void analise_relatorio(void) {
+    static analise_resumo_t r;      // Fora da pilha da tarefa que consulta
+
+    analise_resumo(&r);
+    printf("\n=== analise: %u ocupadas, pico %u desde a partida ===\n", r.ocupadas, r.pico_total);
+    for (size_t j = 0; j < ANALISE_JANELAS; j++) {
+        const analise_janela_t *w = &r.janelas[j];
+        printf("%2u min: media %.2f, pico %u, %lu entradas, %lu saidas\n", w->minutos, w->media,
+               w->pico, (unsigned long)w->entradas, (unsigned long)w->saidas);
+    }
+    printf("permanencia: %lu pareadas, %lu sem entrada\n", (unsigned long)r.estadias,
+           (unsigned long)r.sem_entrada);
+    for (uint i = 0; i < ANALISE_FAIXAS; i++) {
+        if (r.faixas[i] == 0) continue;
+        if (i == ANALISE_FAIXAS - 1) {
+            printf("  >= %6lu s: %lu\n", 1ul << (i - 1), (unsigned long)r.faixas[i]);
+        } else {
+            printf("  < %7lu s: %lu\n", 1ul << i, (unsigned long)r.faixas[i]);
+        }
+    }
+    display_post(TELA_ANALISE, 0, 0);
+}
+
+
+#if !CONTROLE_VAGA_METRICAS
+// Sem entrada no stdio a tarefa só acorda a cada ANALISE_POLL_MS
+static void vTaskAnalise(void *params) {
+    while (true) {
+        int c = getchar_timeout_us(0);
+        if (c == ANALISE_TECLA) {
+            analise_relatorio();
+        } else if (c == PICO_ERROR_TIMEOUT) {
+            vTaskDelay(pdMS_TO_TICKS(ANALISE_POLL_MS));
+        }
+    }
+}
+#endif
@@ -0,0 +1,54 @@
+#ifndef ANALISE_H
+#define ANALISE_H
+
+// Estatísticas de ocupação na placa (CONTROLE_VAGA_ANALISE): média da
+// ocupação total em 1, 15 e 60 minutos, pico, entradas e saídas por janela
+// e histograma do tempo de permanência. A última hora fica num anel de
+// baldes de um minuto e as janelas guardam somas corridas, então cada
+// entrada ou saída custa O(1) e a memória é fixa. O relatório sai pela USB
+// quando chega ANALISE_TECLA no stdio, junto com uma página no display.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "pico/stdlib.h"
+
+#define ANALISE_BALDE_MS 60000      // Um balde por minuto
+#define ANALISE_BALDES 60           // Última hora (a maior janela)
+#define ANALISE_JANELAS 3           // 1, 15 e 60 minutos
+#define ANALISE_ESTADIAS 32         // Entradas lembradas por lote para medir a permanência
+#define ANALISE_FAIXAS 16           // Faixa i: permanência em [2^(i-1), 2^i) s; a última acumula o resto
+#define ANALISE_TECLA 'e'
+#define ANALISE_POLL_MS 100         // Intervalo de leitura do stdio (sem CONTROLE_VAGA_METRICAS)
+
+typedef struct {
+    uint8_t minutos;
+    float media;                    // Ocupação média no período coberto
+    uint16_t pico;
+    uint32_t entradas;
+    uint32_t saidas;
+} analise_janela_t;
+
+typedef struct {
+    analise_janela_t janelas[ANALISE_JANELAS];
+    uint16_t ocupadas;
+    uint16_t pico_total;            // Desde a partida
+    uint32_t estadias;              // Saídas com a entrada conhecida
+    uint32_t sem_entrada;           // Saídas sem entrada registrada (antes da partida ou do anel)
+    uint32_t faixas[ANALISE_FAIXAS];
+} analise_resumo_t;
+
+void analise_init(void);
+void analise_entrada(uint8_t lote);
+void analise_saida(uint8_t lote);
+void analise_reset(void);
+void analise_resumo(analise_resumo_t *out);
+size_t analise_serie(uint16_t *medias_x10, size_t max);
+void analise_relatorio(void);
+
+#define ANALISE_ENTRADA(lote) analise_entrada(lote)
+#define ANALISE_SAIDA(lote) analise_saida(lote)
+#define ANALISE_RESET() analise_reset()
+
+#endif
@@ -0,0 +1,146 @@
+/*
+ *  Tickless idle e modo dormant.
+ *
+ *  O tickless (configUSE_TICKLESS_IDLE) já desliga o tick enquanto todas as
+ *  tarefas estão bloqueadas. O gancho de idle vai além: com o sistema ocioso
+ *  há BAIXO_CONSUMO_OCIOSO_MS, passa clk_ref/clk_sys para o XOSC, desliga as
+ *  PLLs e para o XOSC até uma borda num dos pinos. No dormant o timer também
+ *  para, então o tempo do FreeRTOS não conta o período dormindo.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "hardware/clocks.h"
+#include "hardware/gpio.h"
+#include "hardware/pll.h"
+#include "hardware/structs/iobank0.h"
+#include "hardware/sync.h"
+#include "hardware/xosc.h"
+#if LIB_PICO_STDIO_USB
+#include "pico/stdio_usb.h"
+#endif
+
+#include "baixo_consumo.h"
+#include "controle_vaga.h"
+
+static uint32_t mascara;
+static uint clock_khz;
+static bool (*sistema_ocioso)(void);
+static volatile uint32_t ultima_atividade_us;
+static volatile uint32_t acordou_us;
+static volatile bool medindo;           // Despertar aguardando o primeiro evento tratado
+static baixo_consumo_stats_t stats;
+
+
+void baixo_consumo_init(uint32_t mascara_pinos, uint khz, bool (*ocioso)(void)) {
+    mascara = mascara_pinos;
+    clock_khz = khz;
+    sistema_ocioso = ocioso;
+    ultima_atividade_us = time_us_32();
+}
+
+
+// Chamado pelas tarefas a cada evento tratado
+void baixo_consumo_atividade(void) {
+    uint32_t agora = time_us_32();
+
+    ultima_atividade_us = agora;
+    if (medindo) {
+        uint32_t us = agora - acordou_us;
+        medindo = false;
+        stats.medidas++;
+        stats.ultima_latencia_us = us;
+        stats.soma_latencia_us += us;
+        if (us > stats.max_latencia_us) stats.max_latencia_us = us;
+    }
+}
+
+
+void baixo_consumo_stats(baixo_consumo_stats_t *out) {
+    *out = stats;
+}
+
+
+// clk_sys e clk_peri do XOSC (12 MHz) e PLLs desligadas
+static void roda_do_xosc(void) {
+    uint32_t xosc_hz = XOSC_MHZ * MHZ;
+
+    clock_configure(clk_ref, CLOCKS_CLK_REF_CTRL_SRC_VALUE_XOSC_CLKSRC, 0, xosc_hz, xosc_hz);
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLK_REF, 0, xosc_hz, xosc_hz);
+    clock_stop(clk_usb);
+    clock_stop(clk_adc);
+    clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLK_SYS, xosc_hz, xosc_hz);
+    pll_deinit(pll_sys);
+    pll_deinit(pll_usb);
+}
+
+// Religa a PLL USB (USB e ADC a 48 MHz) e a PLL do sistema
+static void restaura_clocks(void) {
+    pll_init(pll_usb, 1, 1440 * MHZ, 6, 5);
+    clock_configure(clk_usb, 0, CLOCKS_CLK_USB_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, 48 * MHZ, 48 * MHZ);
+    clock_configure(clk_adc, 0, CLOCKS_CLK_ADC_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, 48 * MHZ, 48 * MHZ);
+    set_sys_clock_khz(clock_khz, true);
+}
+
+
+// Entrega ao handler normal a borda que acordou o chip (a detecção de borda
+// do processador não roda com os clocks parados)
+static void entrega_despertar(void) {
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++) {
+        if (!(mascara & (1u << gpio))) continue;
+
+        uint32_t eventos = (io_bank0_hw->dormant_wake_irq_ctrl.ints[gpio / 8] >> (4 * (gpio % 8))) & 0xf;
+        gpio_set_dormant_irq_enabled(gpio, GPIO_IRQ_EDGE_FALL, false);
+        if (eventos & GPIO_IRQ_EDGE_FALL) {
+            gpio_acknowledge_irq(gpio, GPIO_IRQ_EDGE_FALL);
+#if !CONTROLE_VAGA_PIO_DEBOUNCE
+            // Com o debounce por PIO a própria máquina vê o pino ainda em 0
+            gpio_irq_handler(gpio, GPIO_IRQ_EDGE_FALL);
+#endif
+        }
+    }
+}
+
+
+static void dormente(void) {
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++) {
+        if (mascara & (1u << gpio)) {
+            gpio_acknowledge_irq(gpio, GPIO_IRQ_EDGE_FALL);
+            gpio_set_dormant_irq_enabled(gpio, GPIO_IRQ_EDGE_FALL, true);
+        }
+    }
+
+    // Deixa o I2C terminar de esvaziar a FIFO do último quadro
+    busy_wait_us(500);
+    roda_do_xosc();
+    stats.dormencias++;
+    xosc_dormant();
+
+    // Acordado: o timer volta a contar a partir daqui
+    acordou_us = time_us_32();
+    medindo = true;
+    restaura_clocks();
+    entrega_despertar();
+}
+
+
+// Roda na tarefa idle a cada passagem (o tickless a acorda no máximo a cada
+// período da SysTick)
+void vApplicationIdleHook(void) {
+    if (!sistema_ocioso || time_us_32() - ultima_atividade_us < BAIXO_CONSUMO_OCIOSO_MS * 1000u) {
+        return;
+    }
+#if LIB_PICO_STDIO_USB
+    // Com um host USB conectado o dormant derrubaria a serial
+    if (stdio_usb_connected()) {
+        return;
+    }
+#endif
+
+    uint32_t irq = save_and_disable_interrupts();
+    if (sistema_ocioso()) {
+        dormente();
+    }
+    restore_interrupts(irq);
+}
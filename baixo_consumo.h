@@ -0,0 +1,27 @@
+#ifndef BAIXO_CONSUMO_H
+#define BAIXO_CONSUMO_H
+
+// Modo de baixo consumo (CONTROLE_VAGA_BAIXO_CONSUMO): tickless idle entre
+// eventos e, depois de BAIXO_CONSUMO_OCIOSO_MS sem nada pendente, modo
+// dormant com o XOSC parado. Qualquer borda de descida nos pinos registrados
+// acorda o RP2040; o evento é entregue ao gpio_irq_handler normalmente e o
+// tempo do despertar até o evento ser tratado fica em baixo_consumo_stats_t.
+
+#include "pico/stdlib.h"
+
+#define BAIXO_CONSUMO_CLOCK_KHZ 48000   // clk_sys entre um dormant e outro
+#define BAIXO_CONSUMO_OCIOSO_MS 5000    // Silêncio antes de entrar em dormant
+
+typedef struct {
+    uint32_t dormencias;        // Vezes que entrou em dormant
+    uint32_t medidas;           // Despertares que chegaram a um evento tratado
+    uint32_t ultima_latencia_us;
+    uint32_t max_latencia_us;
+    uint64_t soma_latencia_us;
+} baixo_consumo_stats_t;
+
+void baixo_consumo_init(uint32_t mascara_pinos, uint clock_khz, bool (*ocioso)(void));
+void baixo_consumo_atividade(void);
+void baixo_consumo_stats(baixo_consumo_stats_t *stats);
+
+#endif
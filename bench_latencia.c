@@ -0,0 +1,94 @@
+/*
+ *  Benchmark de latência na placa.
+ *
+ *  Um alarme de hardware chama o gpio_irq_handler em contexto de interrupção,
+ *  alternando BUTTON_A e BUTTON_B, e as tarefas registram quanto tempo cada
+ *  evento levou da ISR até ser tratado. A cada BENCH_RELATORIO_MS os
+ *  percentis saem pela USB. Compile com CONTROLE_VAGA_SMP ligado e desligado
+ *  para comparar um e dois núcleos.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "controle_vaga.h"
+
+static uint32_t amostras[BENCH_AMOSTRAS];
+static uint32_t ordenadas[BENCH_AMOSTRAS];
+static uint32_t num_amostras;               // Total desde o início
+static uint32_t injetados, aceitos, recusados;
+
+static void vTaskBenchRelatorio(void *params);
+
+
+// Alarme periódico: simula a borda de descida de um botão
+static int64_t bench_alarme(alarm_id_t id, void *user_data) {
+    static bool entrada = true;
+    uint32_t intervalo_us = (uint32_t)(uintptr_t)user_data;
+
+    injetados++;
+    gpio_irq_handler(entrada ? BUTTON_A : BUTTON_B, GPIO_IRQ_EDGE_FALL);
+    entrada = !entrada;
+    return intervalo_us;
+}
+
+
+void bench_latencia_init(uint32_t intervalo_us) {
+    TaskHandle_t tarefa;
+    CRIA_TAREFA(tarefa, vTaskBenchRelatorio, "BenchTask", configMINIMAL_STACK_SIZE + 256, 1);
+#if CONTROLE_VAGA_SMP
+    vTaskCoreAffinitySet(tarefa, 1 << NUCLEO_IO);
+#endif
+    add_alarm_in_us(intervalo_us, bench_alarme, (void *)(uintptr_t)intervalo_us, true);
+}
+
+
+void bench_latencia_isr(uint gpio, bool aceito) {
+    if (aceito)
+        aceitos++;
+    else
+        recusados++;
+}
+
+
+// Chamado pelas tarefas de eventos (que podem se preemptar entre si)
+void bench_latencia_tarefa(uint gpio, uint32_t irq_us) {
+    uint32_t latencia = time_us_32() - irq_us;
+
+    taskENTER_CRITICAL();
+    amostras[num_amostras++ % BENCH_AMOSTRAS] = latencia;
+    taskEXIT_CRITICAL();
+}
+
+
+static int compara_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+
+static void vTaskBenchRelatorio(void *params) {
+    while (true) {
+        vTaskDelay(pdMS_TO_TICKS(BENCH_RELATORIO_MS));
+
+        taskENTER_CRITICAL();
+        uint32_t total = num_amostras;
+        uint32_t n = total < BENCH_AMOSTRAS ? total : BENCH_AMOSTRAS;
+        memcpy(ordenadas, amostras, n * sizeof(uint32_t));
+        taskEXIT_CRITICAL();
+
+        if (n == 0)
+            continue;
+        qsort(ordenadas, n, sizeof(uint32_t), compara_u32);
+        journal_stats_t journal;
+        controle_vaga_journal_stats(&journal);
+        printf("[bench] nucleos=%d eventos=%lu aceitos=%lu recusados=%lu tratados=%lu "
+               "latencia_us p50=%lu p90=%lu p99=%lu max=%lu journal_descartados=%lu journal_erros=%lu\n",
+               configNUM_CORES, (unsigned long)injetados, (unsigned long)aceitos,
+               (unsigned long)recusados, (unsigned long)total,
+               (unsigned long)ordenadas[n / 2], (unsigned long)ordenadas[(n * 9) / 10],
+               (unsigned long)ordenadas[(n * 99) / 100], (unsigned long)ordenadas[n - 1],
+               (unsigned long)journal.dropped, (unsigned long)journal.errors);
+        alocacao_relatorio();
+    }
+}
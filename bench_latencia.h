@@ -0,0 +1,21 @@
+#ifndef BENCH_LATENCIA_H
+#define BENCH_LATENCIA_H
+
+// Benchmark na placa (CONTROLE_VAGA_BENCH): gera bordas sintéticas a partir
+// de um alarme de hardware e mede a latência ISR -> tarefa, para comparar os
+// builds de um e dois núcleos (CONTROLE_VAGA_SMP).
+
+#include "pico/stdlib.h"
+
+#define BENCH_INTERVALO_US 200000   // Entre bordas (alternando entrada e saída)
+#define BENCH_RELATORIO_MS 10000
+#define BENCH_AMOSTRAS 1024         // Janela das últimas latências
+
+void bench_latencia_init(uint32_t intervalo_us);
+void bench_latencia_isr(uint gpio, bool aceito);
+void bench_latencia_tarefa(uint gpio, uint32_t irq_us);
+
+#define TRACE_EVENTO_ISR(gpio, aceito) bench_latencia_isr((gpio), (aceito))
+#define TRACE_EVENTO_TAREFA(gpio, irq_us) bench_latencia_tarefa((gpio), (irq_us))
+
+#endif
@@ -0,0 +1,363 @@
+/*
+ *  Gerador de tráfego sintético.
+ *
+ *  Cada porta (uma pista ou o botão de reset) tem um processo de chegadas
+ *  com intervalos exponenciais. No modo de rajadas o gerador alterna entre
+ *  calmo e rajada, com durações também exponenciais, e durante a rajada a
+ *  taxa de todas as portas é multiplicada por 'fator' (horário de pico,
+ *  tempestade de resets). Quem chega entra na fila da cancela, que deixa
+ *  passar um por DEBOUNCE_TIME: assim nenhuma borda é filtrada pelo
+ *  debounce do gpio_irq_handler e a diferença entre a ocupação verdadeira e
+ *  a do firmware mede só o que o firmware perdeu ou reordenou.
+ *
+ *  No modo de saturação cada chegada é uma rajada de 'fator' bordas de
+ *  entrada entregues direto ao encaminha_evento, sem cancela nem debounce:
+ *  a fila de eventos enche e descarta. Cada borda recusada é vista pelo
+ *  eventos_descartados e fica fora da ocupação verdadeira. Só entram bordas
+ *  de entrada, que vão todas para a mesma fila e mantêm a ordem.
+ *
+ *  carga_passo é chamado por um alarme de hardware na placa e por uma
+ *  tarefa no bench_carga do host; devolve o instante do próximo passo.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "controle_vaga.h"
+#include "carga.h"
+
+#define SEM_PRAZO UINT64_MAX
+
+typedef struct {
+    uint gpio;
+    tipo_evento_t tipo;
+    uint8_t lote;
+    uint32_t intervalo_ms;          // Média fora das rajadas (0: sem chegadas)
+    uint64_t proxima_chegada;
+    uint64_t livre_em;              // Cancela libera a próxima passagem
+    uint32_t fila;                  // Carros esperando na cancela
+} porta_t;
+
+static const carga_cfg_t perfis[] = {
+    // Entradas mais rápidas que saídas: o lote enche, forma fila e recusa
+    { "pico",       CARGA_POISSON, 450,  900,  0,    0,    0,     1 },
+    // Chegadas esparsas com rajadas oito vezes mais rápidas
+    { "rajada",     CARGA_RAJADA,  2000, 2000, 0,    3000, 10000, 8 },
+    // Resets raros que viram sequências durante as rajadas
+    { "tempestade", CARGA_RAJADA,  800,  800,  4000, 2000, 8000,  10 },
+    // Rajadas de duas filas de eventos inteiras de uma vez: descartes
+    { "saturacao",  CARGA_SATURACAO, 500, 0,   0,    0,    0,     2 * EVENT_RING_SIZE },
+};
+
+static const carga_cfg_t *cfg;
+static porta_t portas[CARGA_MAX_PORTAS];
+static size_t num_portas;
+static uint64_t ultima_passagem[NUM_BANK0_GPIOS];      // Por GPIO, entre rodadas, pelo debounce
+static volatile bool ativo;
+static bool em_rajada;
+static uint64_t troca_em;
+static uint32_t aleatorio;
+
+// Contagens da rodada (escritas só por carga_passo)
+static uint64_t inicio_us, fim_us;
+static uint32_t chegadas, injetados, max_cancela, rajadas, descartes_vistos;
+static uint32_t descartados_inicio;
+static uint16_t capacidade[EST_MAX_LOTES];
+static uint16_t verdade[EST_MAX_LOTES];
+static uint32_t recusas_verdade[EST_MAX_LOTES];
+static uint8_t fila_verdade[EST_MAX_LOTES];
+static uint32_t chegada_verdade[EST_MAX_LOTES][ADMISSAO_MAX];
+static uint32_t recusas_inicio[EST_MAX_LOTES];
+
+
+const carga_cfg_t *carga_perfil(const char *nome) {
+    for (size_t i = 0; i < count_of(perfis); i++) {
+        if (strcmp(perfis[i].nome, nome) == 0) return &perfis[i];
+    }
+    return NULL;
+}
+
+const carga_cfg_t *carga_perfil_indice(size_t i) {
+    return &perfis[i % count_of(perfis)];
+}
+
+
+// xorshift32: barato no M0+ e repetível pela semente
+static uint32_t sorteia(void) {
+    aleatorio ^= aleatorio << 13;
+    aleatorio ^= aleatorio >> 17;
+    aleatorio ^= aleatorio << 5;
+    return aleatorio;
+}
+
+// Amostra exponencial com média 'media_us' (sempre > 0)
+static uint64_t exponencial(uint32_t media_us) {
+    float u = ((sorteia() >> 8) + 1) / 16777216.0f;     // (0, 1]
+    return (uint64_t)(-logf(u) * media_us) + 1;
+}
+
+static uint64_t proxima_chegada(const porta_t *p, uint64_t agora) {
+    if (p->intervalo_ms == 0) return SEM_PRAZO;
+    uint32_t media_us = p->intervalo_ms * 1000u;
+    if (em_rajada) media_us /= cfg->fator;
+    return agora + exponencial(media_us);
+}
+
+
+// Fila de admissão esperada: só os instantes de chegada, para a desistência
+static void fila_descarta_expirados(uint8_t lote, uint32_t agora) {
+    while (fila_verdade[lote] &&
+           agora - chegada_verdade[lote][0] >= (uint32_t)ADMISSAO_ESPERA_MS * 1000u) {
+        memmove(chegada_verdade[lote], chegada_verdade[lote] + 1,
+                --fila_verdade[lote] * sizeof(uint32_t));
+    }
+}
+
+// Estado esperado depois da passagem, na ordem de injeção, com as mesmas
+// regras da fila de admissão
+static void aplica_verdade(const porta_t *p, uint32_t agora) {
+    uint8_t lote = p->lote;
+
+    switch (p->tipo) {
+        case EVENTO_ENTRADA:
+            fila_descarta_expirados(lote, agora);
+            if (fila_verdade[lote] == 0 && verdade[lote] < capacidade[lote]) {
+                verdade[lote]++;
+            } else if (fila_verdade[lote] < ADMISSAO_MAX) {
+                chegada_verdade[lote][fila_verdade[lote]++] = agora;
+            } else {
+                recusas_verdade[lote]++;
+            }
+            break;
+        case EVENTO_SAIDA:
+            if (verdade[lote] == 0) break;
+            verdade[lote]--;
+            fila_descarta_expirados(lote, agora);
+            if (fila_verdade[lote]) {
+                memmove(chegada_verdade[lote], chegada_verdade[lote] + 1,
+                        --fila_verdade[lote] * sizeof(uint32_t));
+                verdade[lote]++;
+            }
+            break;
+        case EVENTO_RESET:
+            memset(verdade, 0, sizeof(verdade));
+            memset(fila_verdade, 0, sizeof(fila_verdade));
+            break;
+    }
+}
+
+static void passa_cancela(porta_t *p) {
+    uint64_t agora = time_us_64();
+
+    p->fila--;
+    ultima_passagem[p->gpio] = agora;
+    p->livre_em = agora + DEBOUNCE_TIME + CARGA_FOLGA_US;
+    aplica_verdade(p, (uint32_t)agora);
+    injetados++;
+    gpio_irq_handler(p->gpio, GPIO_IRQ_EDGE_FALL);
+}
+
+// Modo de saturação: sem cancela nem debounce. Só o que a fila aceitou
+// entra na ocupação verdadeira. A passagem fica registrada para a cancela da
+// rodada seguinte, que pode usar a mesma pista.
+static void injeta_direto(const porta_t *p, uint64_t agora) {
+    uint32_t descartados = eventos_descartados;
+
+    injetados++;
+    ultima_passagem[p->gpio] = agora;
+    encaminha_evento(p->gpio, (uint32_t)agora, (uint32_t)agora);
+    if (eventos_descartados == descartados) {
+        aplica_verdade(p, (uint32_t)agora);
+    } else {
+        descartes_vistos++;
+    }
+}
+
+
+// Começa uma rodada a partir da ocupação atual do firmware (sem eventos
+// pendentes nas filas)
+void carga_inicia(const carga_cfg_t *perfil, uint32_t semente, uint64_t agora) {
+    cfg = perfil;
+    aleatorio = semente ? semente : 1;
+    em_rajada = false;
+    troca_em = cfg->modo == CARGA_RAJADA ? agora + exponencial(cfg->calmo_ms * 1000u) : SEM_PRAZO;
+    chegadas = injetados = max_cancela = rajadas = descartes_vistos = 0;
+    descartados_inicio = eventos_descartados;
+    inicio_us = agora;
+    admissao_limpa();               // A fila esperada começa vazia
+
+    for (size_t i = 0; i < estacionamento_num_lotes(); i++) {
+        lote_resumo_t lote;
+        estacionamento_resumo((uint8_t)i, &lote);
+        capacidade[i] = lote.capacidade;
+        verdade[i] = lote.ocupadas;
+        recusas_verdade[i] = 0;
+        fila_verdade[i] = 0;
+        recusas_inicio[i] = lote.recusas;
+    }
+
+    num_portas = 0;
+    for (size_t i = 0; i < estacionamento_num_pistas(); i++) {
+        const pista_cfg_t *pista = estacionamento_pista_cfg((int)i);
+        bool entrada = pista->sentido == PISTA_ENTRADA;
+        if (!entrada && cfg->modo == CARGA_SATURACAO) continue;
+        portas[num_portas++] = (porta_t){
+            .gpio = pista->gpio,
+            .tipo = entrada ? EVENTO_ENTRADA : EVENTO_SAIDA,
+            .lote = pista->lote,
+            .intervalo_ms = entrada ? cfg->entrada_ms : cfg->saida_ms,
+        };
+    }
+    portas[num_portas++] = (porta_t){ .gpio = BUTTON_JOY, .tipo = EVENTO_RESET,
+                                      .intervalo_ms = cfg->reset_ms };
+
+    for (size_t i = 0; i < num_portas; i++) {
+        portas[i].proxima_chegada = proxima_chegada(&portas[i], agora);
+        portas[i].livre_em = ultima_passagem[portas[i].gpio] + DEBOUNCE_TIME + CARGA_FOLGA_US;
+    }
+    ativo = true;
+}
+
+
+// Gera as chegadas vencidas, abre as cancelas livres e devolve o instante
+// do próximo passo (SEM_PRAZO depois de carga_para)
+uint64_t carga_passo(uint64_t agora) {
+    if (!ativo) return SEM_PRAZO;
+
+    if (agora >= troca_em) {
+        em_rajada = !em_rajada;
+        if (em_rajada) rajadas++;
+        troca_em = agora + exponencial((em_rajada ? cfg->rajada_ms : cfg->calmo_ms) * 1000u);
+        // Intervalos sem memória: basta sortear de novo com a nova taxa
+        for (size_t i = 0; i < num_portas; i++) {
+            portas[i].proxima_chegada = proxima_chegada(&portas[i], agora);
+        }
+    }
+
+    uint64_t proximo = troca_em;
+    for (size_t i = 0; i < num_portas; i++) {
+        porta_t *p = &portas[i];
+
+        while (p->proxima_chegada <= agora) {
+            if (cfg->modo == CARGA_SATURACAO) {
+                for (uint32_t k = 0; k < cfg->fator; k++) {
+                    injeta_direto(p, agora);
+                }
+                chegadas += cfg->fator;
+            } else {
+                p->fila++;
+                chegadas++;
+            }
+            p->proxima_chegada = proxima_chegada(p, p->proxima_chegada);
+        }
+        if (p->fila > max_cancela) max_cancela = p->fila;
+        if (p->fila && agora >= p->livre_em) {
+            passa_cancela(p);
+        }
+
+        if (p->proxima_chegada < proximo) proximo = p->proxima_chegada;
+        if (p->fila && p->livre_em < proximo) proximo = p->livre_em;
+    }
+    return proximo;
+}
+
+
+void carga_para(void) {
+    ativo = false;
+    fim_us = time_us_64();
+}
+
+
+// Espera as tarefas esvaziarem as filas e compara a ocupação do firmware
+// com a esperada. Chamado por uma tarefa depois de carga_para.
+void carga_resultado(carga_resultado_t *r) {
+    while (event_ring_count(&fila_entrada) || event_ring_count(&fila_saida) ||
+           event_ring_count(&fila_reset)) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    vTaskDelay(pdMS_TO_TICKS(100));     // Último lote já retirado da fila
+
+    memset(r, 0, sizeof(*r));
+    r->perfil = cfg->nome;
+    r->duracao_us = fim_us - inicio_us;
+    r->chegadas = chegadas;
+    r->injetados = injetados;
+    r->max_cancela = max_cancela;
+    r->descartados = eventos_descartados - descartados_inicio;
+    r->descartes_vistos = descartes_vistos;
+    r->rajadas = rajadas;
+    for (size_t i = 0; i < num_portas; i++) {
+        r->na_cancela += portas[i].fila;
+    }
+
+    r->num_lotes = (uint8_t)estacionamento_num_lotes();
+    for (size_t i = 0; i < r->num_lotes; i++) {
+        lote_resumo_t lote;
+        estacionamento_resumo((uint8_t)i, &lote);
+        r->verdade[i] = verdade[i];
+        r->recusas_verdade[i] = recusas_verdade[i];
+        r->ocupadas[i] = lote.ocupadas;
+        r->recusas[i] = lote.recusas - recusas_inicio[i];
+    }
+}
+
+
+void carga_imprime(const carga_resultado_t *r) {
+    double segundos = r->duracao_us / 1e6;
+
+    printf("[carga] perfil=%s %.1f s: %lu chegadas, %lu injetados (%.2f eventos/s), "
+           "%lu na cancela (max %lu), %lu rajadas\n",
+           r->perfil, segundos, (unsigned long)r->chegadas, (unsigned long)r->injetados,
+           segundos > 0 ? r->injetados / segundos : 0.0, (unsigned long)r->na_cancela,
+           (unsigned long)r->max_cancela, (unsigned long)r->rajadas);
+    printf("[carga] descartados=%lu, vistos pelo gerador %lu (limite %u por fila, pico e/s/r %lu/%lu/%lu)\n",
+           (unsigned long)r->descartados, (unsigned long)r->descartes_vistos, EVENT_RING_SIZE,
+           (unsigned long)fila_entrada.high_water,
+           (unsigned long)fila_saida.high_water, (unsigned long)fila_reset.high_water);
+    for (size_t i = 0; i < r->num_lotes; i++) {
+        bool confere = r->ocupadas[i] == r->verdade[i] && r->recusas[i] == r->recusas_verdade[i];
+        printf("[carga] lote %u: firmware %u (%lu recusas), esperado %u (%lu recusas) %s\n",
+               (unsigned)i, r->ocupadas[i], (unsigned long)r->recusas[i], r->verdade[i],
+               (unsigned long)r->recusas_verdade[i], confere ? "ok" : "DIVERGE");
+    }
+}
+
+
+#ifndef CONTROLE_VAGA_HOST
+static void vTaskCarga(void *params);
+
+// Alarme de hardware: roda em contexto de interrupção, como um botão
+static int64_t carga_alarme(alarm_id_t id, void *user_data) {
+    uint64_t agora = time_us_64();
+    uint64_t proximo = carga_passo(agora);
+
+    if (proximo == SEM_PRAZO) return 0;
+    return -(int64_t)(proximo > agora ? proximo - agora : 1);
+}
+
+
+// Na placa os perfis se alternam em rodadas de CARGA_DURACAO_MS
+void carga_init(void) {
+    TaskHandle_t tarefa;
+    CRIA_TAREFA(tarefa, vTaskCarga, "CargaTask", CARGA_PILHA, 1);
+#if CONTROLE_VAGA_SMP
+    // O alarme interrompe o núcleo que o cria: o mesmo dos botões
+    vTaskCoreAffinitySet(tarefa, 1 << NUCLEO_EVENTOS);
+#endif
+}
+
+
+static void vTaskCarga(void *params) {
+    carga_resultado_t resultado;
+
+    for (size_t rodada = 0;; rodada++) {
+        carga_inicia(carga_perfil_indice(rodada), time_us_32(), time_us_64());
+        add_alarm_in_us(1, carga_alarme, NULL, true);
+        vTaskDelay(pdMS_TO_TICKS(CARGA_DURACAO_MS));
+
+        carga_para();
+        carga_resultado(&resultado);
+        carga_imprime(&resultado);
+    }
+}
+#endif
@@ -0,0 +1,71 @@
+#ifndef CARGA_H
+#define CARGA_H
+
+// Gerador de tráfego sintético (CONTROLE_VAGA_CARGA e bench_carga do host).
+// Cada pista e o botão de reset recebem chegadas de Poisson, ou em rajadas
+// (a taxa é multiplicada enquanto dura uma rajada); quem chega espera na
+// cancela e passa um por janela de debounce, pelo mesmo gpio_irq_handler
+// dos botões. O modo de saturação pula a cancela e o debounce e entrega
+// rajadas de bordas direto às filas de eventos, mais rápido do que as
+// tarefas consomem. O gerador mantém a ocupação verdadeira de cada lote para
+// comparar com a do firmware no fim da rodada.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pico/stdlib.h"
+#include "estacionamento.h"
+
+#define CARGA_MAX_PORTAS (EST_MAX_PISTAS + 1)  // Pistas e o botão de reset
+#define CARGA_FOLGA_US 2000         // Margem além do DEBOUNCE_TIME entre duas passagens
+#define CARGA_DURACAO_MS 60000      // Rodada na placa
+#define CARGA_PILHA (configMINIMAL_STACK_SIZE + 256)
+
+typedef enum {
+    CARGA_POISSON,
+    CARGA_RAJADA,
+    CARGA_SATURACAO,                // 'fator' bordas de uma vez, direto na fila (só entradas)
+} carga_modo_t;
+
+typedef struct {
+    const char *nome;
+    carga_modo_t modo;
+    uint32_t entrada_ms;            // Intervalo médio entre chegadas por pista de entrada (0: nenhuma)
+    uint32_t saida_ms;              // Idem por pista de saída
+    uint32_t reset_ms;              // Idem para o botão de reset
+    uint32_t rajada_ms;             // Duração média de uma rajada (CARGA_RAJADA)
+    uint32_t calmo_ms;              // Duração média entre rajadas
+    uint32_t fator;                 // Multiplicador da taxa durante a rajada
+} carga_cfg_t;
+
+typedef struct {
+    const char *perfil;
+    uint64_t duracao_us;
+    uint32_t chegadas;              // Carros e apertos de reset gerados
+    uint32_t injetados;             // Bordas entregues ao gpio_irq_handler
+    uint32_t na_cancela;            // Ainda esperando no fim da rodada
+    uint32_t max_cancela;           // Maior espera numa cancela
+    uint32_t descartados;           // Fila de eventos cheia (eventos_descartados)
+    uint32_t descartes_vistos;      // Dos injetados, quantos a fila recusou
+    uint32_t rajadas;
+    uint8_t num_lotes;
+    uint16_t verdade[EST_MAX_LOTES];        // Ocupação esperada
+    uint32_t recusas_verdade[EST_MAX_LOTES];
+    uint16_t ocupadas[EST_MAX_LOTES];       // Ocupação do firmware
+    uint32_t recusas[EST_MAX_LOTES];
+} carga_resultado_t;
+
+const carga_cfg_t *carga_perfil(const char *nome);
+const carga_cfg_t *carga_perfil_indice(size_t i);
+
+void carga_inicia(const carga_cfg_t *cfg, uint32_t semente, uint64_t agora);
+uint64_t carga_passo(uint64_t agora);
+void carga_para(void);
+void carga_resultado(carga_resultado_t *r);
+void carga_imprime(const carga_resultado_t *r);
+
+#ifndef CONTROLE_VAGA_HOST
+void carga_init(void);
+#endif
+
+#endif
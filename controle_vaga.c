@@ -5,223 +5,503 @@
 
 #include "controle_vaga.h"
 
-SemaphoreHandle_t xSemaforoEntrada;
-SemaphoreHandle_t xSemaforoSaida;
-SemaphoreHandle_t xSemaforoReset;
-SemaphoreHandle_t xDisplayMutex;
-uint16_t eventosProcessados = 0;
-uint MAX = 5; // Número máximo de vagas no estacionamento
-uint vagas_preenchidas = 0;
+// Filas ISR -> tarefa (uma por tipo de evento, cada uma com um só consumidor)
+event_ring_t fila_entrada;
+event_ring_t fila_saida;
+event_ring_t fila_reset;
+TaskHandle_t xTaskEntrada;
+TaskHandle_t xTaskSaida;
+TaskHandle_t xTaskReset;
+TaskHandle_t xTaskLeds;
+TaskHandle_t xTaskJournal;
+uint32_t eventos_descartados = 0;
+
+// Lotes e pistas: cada GPIO de pista entra ou sai de um lote
+static const lote_cfg_t lotes[] = {
+    { "Lote 1", 5, 1, 1 },  // Número máximo de vagas, níveis e zonas por nível
+};
+static const pista_cfg_t pistas[] = {
+    { BUTTON_A, 0, PISTA_ENTRADA },
+    { BUTTON_B, 0, PISTA_SAIDA },
+};
+static uint32_t ultimo_evento_pista[EST_MAX_PISTAS];   // Debounce por pista
+static TimerHandle_t xTimerFila;    // Varre as filas de admissão enquanto alguém espera
+
+// Barramento do display
+#if CONTROLE_VAGA_DISPLAY_SPI
+static ssd1306_spi_t barramento_display;
+#else
+static ssd1306_i2c_t barramento_display;
+#endif
+
+// Ocupação de cada lote (uma chave por lote) persistida na flash
+static journal_flash_t journal_flash;
+static journal_t journal;
+
+// Sinais sonoros (tocados em segundo plano pelo sequenciador do buzzer)
+static const buzzer_tone_t tom_entrada[] = { { 1200, 250, 250 } };
+static const buzzer_tone_t tom_fila[] = { { 800, 150, 150 } };
+static const buzzer_tone_t tom_lotado[] = { { 500, 500, 500 } };
+static const buzzer_tone_t tom_reset[] = { { 1000, 500, 500 } };
+static const buzzer_pattern_t bip_entrada = { tom_entrada, 1, 1, 1 };
+static const buzzer_pattern_t bip_fila = { tom_fila, 1, 2, 2 };
+static const buzzer_pattern_t bip_lotado = { tom_lotado, 1, 1, 2 };
+static const buzzer_pattern_t bip_reset = { tom_reset, 1, 2, 3 };
 
 void vTaskEntrada(void *params);
 void vTaskSaida(void *params);
 void vTaskReset(void *params);
 void vTaskLeds(void *params);
-void gpio_irq_handler(uint gpio, uint32_t events);
+void vTaskJournal(void *params);
 void init_gpio_button(uint gpio);
 void init_gpio_led(uint gpio);
+static void leds_notifica(void);
+static void journal_registra(journal_kind_t tipo, uint8_t lote, int16_t valor, uint32_t timestamp);
+#if CONTROLE_VAGA_BAIXO_CONSUMO
+static bool sistema_ocioso(void);
+#endif
+static void varre_filas(TimerHandle_t timer);
 
 
+#ifndef CONTROLE_VAGA_HOST
 int main() {
     stdio_init_all();
 
+    if (!controle_vaga_init()) {
+        return -1;
+    }
+#if CONTROLE_VAGA_BENCH
+    bench_latencia_init(BENCH_INTERVALO_US);
+#elif CONTROLE_VAGA_METRICAS
+    metricas_init();
+#endif
+#if CONTROLE_VAGA_TELEMETRIA
+    telemetria_init();
+#endif
+#if CONTROLE_VAGA_ANALISE
+    analise_init();
+#endif
+#if CONTROLE_VAGA_CARGA
+    carga_init();
+#endif
+#if CONTROLE_VAGA_REDE
+    rede_init();
+#endif
+
+    vTaskStartScheduler();
+    panic_unsupported();
+}
+#endif
+
+
+// Configura o hardware e cria semáforos e tarefas (compartilhado com o build do host)
+bool controle_vaga_init(void) {
     // Configura clock do sistema
-    if (set_sys_clock_khz(128000, false)) {
+    if (set_sys_clock_khz(CLOCK_SISTEMA_KHZ, false)) {
         printf("Configuração do clock do sistema completa!\n");
     } else {
         printf("Configuração do clock do sistema falhou!\n");
-        return -1;
+        return false;
     }
 
     // Inicialização do display
-    i2c_init(I2C_PORT, 400 * 1000);
+#if CONTROLE_VAGA_DISPLAY_SPI
+    const ssd1306_bus_t *barramento = ssd1306_spi_init(&barramento_display, SPI_PORT, SPI_FREQ, SPI_DC, SPI_CS);
+    gpio_set_function(SPI_SCK, GPIO_FUNC_SPI);
+    gpio_set_function(SPI_MOSI, GPIO_FUNC_SPI);
+    gpio_init(SPI_RES);
+    gpio_set_dir(SPI_RES, GPIO_OUT);
+    gpio_put(SPI_RES, 0);           // Pulso de reset antes da configuração
+    sleep_ms(1);
+    gpio_put(SPI_RES, 1);
+#else
+    const ssd1306_bus_t *barramento = ssd1306_i2c_init(&barramento_display, I2C_PORT, ENDERECO, CONTROLE_VAGA_I2C_HZ);
     gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
     gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
     gpio_pull_up(I2C_SDA);
     gpio_pull_up(I2C_SCL);
-    ssd1306_init(&ssd, WIDTH, HEIGHT, false, ENDERECO, I2C_PORT);
-    ssd1306_config(&ssd);
-    ssd1306_send_data(&ssd);
+#endif
+    display_init(barramento);
 
     // Configuração do buzzer
     buzzer_setup_pwm(BUZZER_PIN, 4000);
 
-    // Configura os botões
-    init_gpio_button(BUTTON_A);
-    init_gpio_button(BUTTON_B);
+    // Configura as pistas e o botão de reset
+    if (!estacionamento_init(lotes, count_of(lotes), pistas, count_of(pistas))) {
+        printf("Tabela de lotes e pistas inválida!\n");
+        return false;
+    }
+    for (size_t i = 0; i < count_of(pistas); i++) {
+        init_gpio_button(pistas[i].gpio);
+    }
     init_gpio_button(BUTTON_JOY);
-    gpio_set_irq_enabled_with_callback(BUTTON_A, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
-    gpio_set_irq_enabled(BUTTON_B, GPIO_IRQ_EDGE_FALL, true);
-    gpio_set_irq_enabled(BUTTON_JOY, GPIO_IRQ_EDGE_FALL, true);
 
-    // Cria semáforos de contagem, semáforo binário e mutex
-    xSemaforoEntrada = xSemaphoreCreateCounting(10, 0);
-    xSemaforoSaida = xSemaphoreCreateCounting(10, 0);
-    xSemaforoReset = xSemaphoreCreateBinary();
-    xDisplayMutex = xSemaphoreCreateMutex();
+    // Restaura a ocupação: checkpoint e fim do setor mais recente do journal
+    uint32_t inicio = time_us_32();
+    journal_flash_rp2040(&journal_flash, JOURNAL_OFFSET, JOURNAL_SETORES);
+    if (!journal_init(&journal, &journal_flash, count_of(lotes))) {
+        printf("Journal da flash inválido!\n");
+        return false;
+    }
+    for (size_t i = 0; i < count_of(lotes); i++) {
+        estacionamento_define(i, journal_state(&journal, i));
+    }
+    if (!vagas_init(lotes, count_of(lotes))) {
+        printf("Vagas demais para o mapa de vagas!\n");
+        return false;
+    }
+    admissao_init();
+    CRIA_TIMER(xTimerFila, "FilaAdmissao", pdMS_TO_TICKS(ADMISSAO_VARREDURA_MS), pdFALSE, NULL,
+               varre_filas);
+    printf("Ocupação restaurada em %lu us (%lu registros)\n",
+           (unsigned long)(time_us_32() - inicio), (unsigned long)journal.stats.replayed);
+
+    // Cria as filas de eventos
+    event_ring_init(&fila_entrada);
+    event_ring_init(&fila_saida);
+    event_ring_init(&fila_reset);
 
     // Cria tarefas
-    xTaskCreate(vTaskEntrada, "EntradaTask", configMINIMAL_STACK_SIZE + 128, NULL, 1, NULL);
-    xTaskCreate(vTaskSaida, "SaidaTask", configMINIMAL_STACK_SIZE + 128, NULL, 1, NULL);
-    xTaskCreate(vTaskReset, "ResetTask", configMINIMAL_STACK_SIZE + 128, NULL, 1, NULL);
-    xTaskCreate(vTaskLeds, "LedsTask", configMINIMAL_STACK_SIZE + 128, NULL, 1, NULL);
+    CRIA_TAREFA(xTaskEntrada, vTaskEntrada, "EntradaTask", PILHA_EVENTOS, 1);
+    CRIA_TAREFA(xTaskSaida, vTaskSaida, "SaidaTask", PILHA_EVENTOS, 1);
+    CRIA_TAREFA(xTaskReset, vTaskReset, "ResetTask", PILHA_EVENTOS, 1);
+    CRIA_TAREFA(xTaskLeds, vTaskLeds, "LedsTask", PILHA_LEDS, 1);
+    CRIA_TAREFA(xTaskJournal, vTaskJournal, "JournalTask", PILHA_JOURNAL, tskIDLE_PRIORITY);
+
+#if CONTROLE_VAGA_SMP
+    // Núcleo 0 recebe as interrupções dos botões e cuida da ocupação;
+    // núcleo 1 fica com o display, os LEDs e o buzzer
+    vTaskCoreAffinitySet(xTaskEntrada, 1 << NUCLEO_EVENTOS);
+    vTaskCoreAffinitySet(xTaskSaida, 1 << NUCLEO_EVENTOS);
+    vTaskCoreAffinitySet(xTaskReset, 1 << NUCLEO_EVENTOS);
+    vTaskCoreAffinitySet(xTaskLeds, 1 << NUCLEO_IO);
+    vTaskCoreAffinitySet(display_task(), 1 << NUCLEO_IO);
+#endif
+
+    // Interrupções só depois que os consumidores existem
+    uint32_t pinos = 1u << BUTTON_JOY;
+    for (size_t i = 0; i < count_of(pistas); i++) {
+        pinos |= 1u << pistas[i].gpio;
+    }
+#if CONTROLE_VAGA_PIO_DEBOUNCE
+    // Uma máquina do PIO por entrada filtra a trepidação; a CPU só é
+    // interrompida por bordas limpas e não há bloqueio de DEBOUNCE_TIME
+    pio_debounce_init(PIO_JANELA_US, encaminha_evento);
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++) {
+        if ((pinos & (1u << gpio)) && !pio_debounce_add_pin(gpio)) {
+            printf("Sem máquina de PIO para o GPIO %u!\n", gpio);
+            return false;
+        }
+    }
+#else
+    gpio_set_irq_enabled_with_callback(BUTTON_JOY, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
+    for (size_t i = 0; i < count_of(pistas); i++) {
+        gpio_set_irq_enabled(pistas[i].gpio, GPIO_IRQ_EDGE_FALL, true);
+    }
+#endif
+#if CONTROLE_VAGA_BAIXO_CONSUMO
+    // Os mesmos pinos acordam o chip do dormant
+    baixo_consumo_init(pinos, CLOCK_SISTEMA_KHZ, sistema_ocioso);
+#else
+    (void)pinos;
+#endif
+
+    return true;
+}
 
-    vTaskStartScheduler();
-    panic_unsupported();
+
+#if CONTROLE_VAGA_BAIXO_CONSUMO
+// Nada pendente: filas vazias, buzzer calado, display parado na tela de
+// espera, journal gravado e ninguém na fila de admissão
+static bool sistema_ocioso(void) {
+    return event_ring_count(&fila_entrada) == 0 && event_ring_count(&fila_saida) == 0 &&
+           event_ring_count(&fila_reset) == 0 && !buzzer_busy() && display_ocioso() &&
+           journal_pending(&journal) == 0 && !xTimerIsTimerActive(xTimerFila);
+}
+#define ATIVIDADE() baixo_consumo_atividade()
+#else
+#define ATIVIDADE()
+#endif
+
+
+// Roda na tarefa de timers enquanto há carro na fila de admissão. Sem
+// tráfego ninguém mais tiraria da fila quem desistiu, e a rede e o "+N" da
+// tela de espera ficariam com a fila velha.
+static void varre_filas(TimerHandle_t timer) {
+    uint16_t esperando;
+
+    if (admissao_expira(time_us_32(), &esperando)) {
+        REDE_MUDOU();
+        if (display_ocioso()) {
+            display_post(TELA_ESPERA, 0, 0);
+        }
+    }
+    if (esperando) {
+        xTimerStart(timer, 0);
+    }
 }
 
 
-// Preenche uma vaga no estacionamento
-void vTaskEntrada(void *params) {
-    char buffer[32];
-
-    // Tela inicial
-    if (xSemaphoreTake(xDisplayMutex, portMAX_DELAY) == pdTRUE) {
-        ssd1306_fill(&ssd, 0);
-        ssd1306_draw_string(&ssd, "Aguardando ", 5, 25);
-        ssd1306_draw_string(&ssd, "  evento...", 5, 34);
-        ssd1306_send_data(&ssd);
-        xSemaphoreGive(xDisplayMutex);
+// Vaga ocupada, direto ou pela fila de admissão
+static void confirma_entrada(uint8_t lote, uint16_t ocupadas, int16_t vaga, uint32_t timestamp) {
+    TELEMETRIA_OCUPACAO(lote, 1, ocupadas);
+    ANALISE_ENTRADA(lote);
+    buzzer_submit(&bip_entrada);
+    journal_registra(JOURNAL_DELTA, lote, 1, timestamp);
+    leds_notifica();
+    REDE_MUDOU();
+
+    // Atualiza display com a nova contagem e a vaga (volta sozinho à tela de espera)
+    display_post_entrada(lote, ocupadas, vaga);
+}
+
+
+// Preenche uma vaga no lote da pista ou põe o carro na fila de admissão
+static void processa_entrada(const event_t *ev) {
+    uint8_t lote = estacionamento_pista_cfg(ev->lane)->lote;
+    admissao_carro_t carro = { .chegada_us = ev->timestamp_us, .pista = ev->lane };
+    uint16_t ocupadas;
+    int16_t vaga;
+    uint8_t posicao;
+
+    TRACE_EVENTO_TAREFA(ev->gpio, ev->irq_us);
+    ATIVIDADE();
+    switch (admissao_chega(lote, &carro, &ocupadas, &vaga, &posicao)) {
+        case ADMISSAO_ENTROU:
+            confirma_entrada(lote, ocupadas, vaga, ev->timestamp_us);
+            break;
+        case ADMISSAO_NA_FILA:
+            xTimerStart(xTimerFila, 0);
+            buzzer_submit(&bip_fila);
+            REDE_MUDOU();
+            display_post_fila(lote, posicao, admissao_espera_ms(lote, posicao));
+            break;
+        case ADMISSAO_LOTADO: {
+            lote_resumo_t resumo;
+            estacionamento_recusa(lote);
+            REDE_MUDOU();
+            estacionamento_resumo(lote, &resumo);
+            buzzer_submit(&bip_lotado);
+            display_post(TELA_ENTRADA, lote, resumo.ocupadas);
+            break;
+        }
     }
+}
 
-    while (true) {
-        // Aguarda semáforo (um evento)
-        if (xSemaphoreTake(xSemaforoEntrada, portMAX_DELAY) == pdTRUE) {
-            if (eventosProcessados == MAX) {
-                buzzer_play(BUZZER_PIN, 1, 500, 500);
-            } else {
-                buzzer_play(BUZZER_PIN, 1, 1200, 250);
-                eventosProcessados++;
-            }
-
-            if (xSemaphoreTake(xDisplayMutex, portMAX_DELAY) == pdTRUE) {
-                // Atualiza display com a nova contagem
-                ssd1306_fill(&ssd, 0);
-                sprintf(buffer, "Eventos: %d", eventosProcessados);
-                ssd1306_draw_string(&ssd, "Evento ", 5, 10);
-                ssd1306_draw_string(&ssd, "recebido!", 5, 19);
-                ssd1306_draw_string(&ssd, buffer, 5, 44);
-                ssd1306_send_data(&ssd);
-                xSemaphoreGive(xDisplayMutex);
-            }
-
-            // Simula tempo de processamento
-            vTaskDelay(pdMS_TO_TICKS(1500));
-
-            if (xSemaphoreTake(xDisplayMutex, portMAX_DELAY) == pdTRUE) {
-                // Retorna à tela de espera
-                ssd1306_fill(&ssd, 0);
-                ssd1306_draw_string(&ssd, "Aguardando ", 5, 25);
-                ssd1306_draw_string(&ssd, "  evento...", 5, 34);
-                ssd1306_send_data(&ssd);
-                xSemaphoreGive(xDisplayMutex);
-            }
+
+// Libera uma vaga no lote da pista e a passa ao primeiro da fila
+static void processa_saida(const event_t *ev) {
+    uint8_t lote = estacionamento_pista_cfg(ev->lane)->lote;
+    admissao_carro_t carro;
+    uint16_t ocupadas;
+    int16_t vaga;
+
+    TRACE_EVENTO_TAREFA(ev->gpio, ev->irq_us);
+    ATIVIDADE();
+    if (admissao_saida(lote, ev->timestamp_us, &ocupadas)) {
+        TELEMETRIA_OCUPACAO(lote, -1, ocupadas);
+        ANALISE_SAIDA(lote);
+        journal_registra(JOURNAL_DELTA, lote, -1, ev->timestamp_us);
+        REDE_MUDOU();
+        if (admissao_admite(lote, ev->timestamp_us, &carro, &ocupadas, &vaga)) {
+            confirma_entrada(lote, ocupadas, vaga, ev->timestamp_us);
+        } else {
+            leds_notifica();
+            display_post(TELA_SAIDA, lote, ocupadas);
         }
     }
 }
 
 
-// Libera uma vaga no estacionamento
-void vTaskSaida(void *params) {
-    char buffer[32];
+// Esvazia (reseta) todos os lotes.
+static void processa_reset(const event_t *ev) {
+    TRACE_EVENTO_TAREFA(ev->gpio, ev->irq_us);
+    ATIVIDADE();
+    buzzer_submit(&bip_reset);
+    admissao_esvazia();
+    ANALISE_RESET();
+    for (size_t i = 0; i < count_of(lotes); i++) {
+        TELEMETRIA_OCUPACAO(i, 0, 0);
+        journal_registra(JOURNAL_SET, i, 0, ev->timestamp_us);
+    }
+    leds_notifica();
+    REDE_MUDOU();
 
-    while (true) {
-        if (xSemaphoreTake(xSemaforoSaida, portMAX_DELAY) == pdTRUE) {
-            if (eventosProcessados > 0) {
-                eventosProcessados--;
-                if (xSemaphoreTake(xDisplayMutex, portMAX_DELAY) == pdTRUE) {
-                    ssd1306_fill(&ssd, 0);
-                    sprintf(buffer, "Eventos: %d", eventosProcessados);
-                    ssd1306_draw_string(&ssd, "Saida!", 5, 10);
-                    ssd1306_draw_string(&ssd, buffer, 5, 44);
-                    ssd1306_send_data(&ssd);
-                    xSemaphoreGive(xDisplayMutex);
-                }
-
-                vTaskDelay(pdMS_TO_TICKS(1500));
-
-                if (xSemaphoreTake(xDisplayMutex, portMAX_DELAY) == pdTRUE) {
-                    ssd1306_fill(&ssd, 0);
-                    ssd1306_draw_string(&ssd, "Aguardando ", 5, 25);
-                    ssd1306_draw_string(&ssd, "  evento...", 5, 34);
-                    ssd1306_send_data(&ssd);
-                    xSemaphoreGive(xDisplayMutex);
-                }
-            }
+    display_post(TELA_RESET, 0, 0);
+}
+
+
+// Aguarda a notificação da ISR e consome a fila em lotes, na ordem de chegada
+static void consome_eventos(event_ring_t *fila, void (*processa)(const event_t *ev)) {
+    event_t lote[EVENTOS_POR_LOTE];
+    size_t n;
+
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    while ((n = event_ring_pop_batch(fila, lote, EVENTOS_POR_LOTE)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            TELEMETRIA_LATENCIA(lote[i].gpio, lote[i].irq_us);
+            processa(&lote[i]);
         }
     }
 }
 
 
-// Esvazia (reseta) o estacionamento.
-void vTaskReset(void *params) {
-    char buffer[32];
+void vTaskEntrada(void *params) {
+    while (true) {
+        consome_eventos(&fila_entrada, processa_entrada);
+    }
+}
+
 
+void vTaskSaida(void *params) {
     while (true) {
-        if (xSemaphoreTake(xSemaforoReset, portMAX_DELAY) == pdTRUE) {
-            buzzer_play(BUZZER_PIN, 2, 1000, 500);
-            eventosProcessados = 0;
-            vagas_preenchidas = 0;
-
-            if (xSemaphoreTake(xDisplayMutex, portMAX_DELAY) == pdTRUE) {
-                ssd1306_fill(&ssd, 0);
-                ssd1306_draw_string(&ssd, "Contador ", 5, 10);
-                ssd1306_draw_string(&ssd, "resetado!", 5, 19);
-                sprintf(buffer, "Eventos: %d", eventosProcessados);
-                ssd1306_draw_string(&ssd, buffer, 5, 44);
-                ssd1306_send_data(&ssd);
-                xSemaphoreGive(xDisplayMutex);
-            }
-
-            vTaskDelay(pdMS_TO_TICKS(1500));
-
-            if (xSemaphoreTake(xDisplayMutex, portMAX_DELAY) == pdTRUE) {
-                // Retorna à tela de espera
-                ssd1306_fill(&ssd, 0);
-                ssd1306_draw_string(&ssd, "Aguardando ", 5, 25);
-                ssd1306_draw_string(&ssd, "  evento...", 5, 34);
-                ssd1306_send_data(&ssd);
-                xSemaphoreGive(xDisplayMutex);
-            }
-        }
+        consome_eventos(&fila_saida, processa_saida);
     }
 }
 
 
-// Controla os LEDs RGB de acordo com a quantidade de vagas ocupadas.
+void vTaskReset(void *params) {
+    while (true) {
+        consome_eventos(&fila_reset, processa_reset);
+    }
+}
+
+
+// Cor dos LEDs para a ocupação somada de todos os lotes: azul vazio,
+// vermelho cheio, amarelo com uma vaga restante e verde no resto. No modo
+// PWM o verde vai virando vermelho conforme o estacionamento enche.
+static cor_t cor_da_ocupacao(uint16_t ocupadas, uint16_t capacidade) {
+    if (ocupadas == 0) {
+        return (cor_t){ 0, 0, LED_NIVEL_MAX };
+    }
+    if (ocupadas >= capacidade) {
+        return (cor_t){ LED_NIVEL_MAX, 0, 0 };
+    }
+#if CONTROLE_VAGA_LED_PWM
+    uint8_t vermelho = (uint8_t)((uint32_t)LED_NIVEL_MAX * ocupadas / capacidade);
+    return (cor_t){ vermelho, LED_NIVEL_MAX - vermelho, 0 };
+#else
+    if (ocupadas == capacidade - 1) {
+        return (cor_t){ LED_NIVEL_MAX, LED_NIVEL_MAX, 0 };
+    }
+    return (cor_t){ 0, LED_NIVEL_MAX, 0 };
+#endif
+}
+
+
+// Escreve só os canais que mudaram desde a última cor
+static void leds_aplica(cor_t cor) {
+    static cor_t atual;     // init_gpio_led deixa tudo apagado
+    const uint pinos[3] = { LED_RED_PIN, LED_GREEN_PIN, LED_BLUE_PIN };
+    const uint8_t novo[3] = { cor.r, cor.g, cor.b };
+    const uint8_t antigo[3] = { atual.r, atual.g, atual.b };
+
+    for (int i = 0; i < 3; i++) {
+        if (novo[i] == antigo[i]) continue;
+#if CONTROLE_VAGA_LED_PWM
+        pwm_set_chan_level(pwm_gpio_to_slice_num(pinos[i]), pwm_gpio_to_channel(pinos[i]), novo[i]);
+#else
+        gpio_put(pinos[i], novo[i] != 0);
+#endif
+    }
+    atual = cor;
+}
+
+
+// Controla os LEDs RGB de acordo com a quantidade de vagas ocupadas. A
+// tarefa dorme até alguém mudar a ocupação (leds_notifica).
 void vTaskLeds(void *params) {
     // Configura os LEDs
     init_gpio_led(LED_RED_PIN);
     init_gpio_led(LED_BLUE_PIN);
     init_gpio_led(LED_GREEN_PIN);
 
+#if CONTROLE_VAGA_SMP
+    // Um pool de alarmes criado aqui interrompe o núcleo desta tarefa, então
+    // os passos do buzzer também rodam no núcleo de E/S
+    buzzer_set_alarm_pool(alarm_pool_create_with_unused_hardware_alarm(4));
+#endif
+
     while (true) {
-        // Liga o LED azul se não tiver vagas ocupadas
-        if (eventosProcessados == 0) {
-            gpio_put(LED_RED_PIN, 0);
-            gpio_put(LED_GREEN_PIN, 0);
-            gpio_put(LED_BLUE_PIN, 1);
-        }
-        // Liga o LED verde se houver vagas ocupadas dentro da faixa
-        else if (eventosProcessados < MAX-2 && eventosProcessados > 0) {
-            gpio_put(LED_RED_PIN, 0);
-            gpio_put(LED_GREEN_PIN, 1);
-            gpio_put(LED_BLUE_PIN, 0);
-        }
-        // Liga o LED amarelo se houver apenas uma vaga restante
-        else if (eventosProcessados == MAX-1) {
-            gpio_put(LED_RED_PIN, 1);
-            gpio_put(LED_GREEN_PIN, 1);
-            gpio_put(LED_BLUE_PIN, 0);
-        }
-        // Liga o LED vermelho se o contador de eventos for igual a MAX
-        else if (eventosProcessados == MAX) {
-            gpio_put(LED_RED_PIN, 1);
-            gpio_put(LED_GREEN_PIN, 0);
-            gpio_put(LED_BLUE_PIN, 0);
+        // Os LEDs mostram a soma de todos os lotes
+        uint16_t capacidade;
+        uint16_t ocupadas = estacionamento_total(&capacidade);
+
+        leds_aplica(cor_da_ocupacao(ocupadas, capacidade));
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+
+static void leds_notifica(void) {
+    xTaskNotifyGive(xTaskLeds);
+}
+
+
+void controle_vaga_journal_stats(journal_stats_t *stats) {
+    journal_get_stats(&journal, stats);
+}
+
+
+// Só copia o registro para a RAM; quem grava na flash é a vTaskJournal
+static void journal_registra(journal_kind_t tipo, uint8_t lote, int16_t valor, uint32_t timestamp) {
+    journal_append(&journal, tipo, lote, valor, timestamp);
+    xTaskNotifyGive(xTaskJournal);
+}
+
+
+// Grava o journal com a menor prioridade. Espera JOURNAL_LOTE_MS depois do
+// primeiro registro para gravar vários de uma vez e, sem nada pendente,
+// apaga o próximo setor com antecedência. Gravar/apagar pausa o XIP (e as
+// interrupções) por ~1 ms por página e dezenas de ms por setor.
+void vTaskJournal(void *params) {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        vTaskDelay(pdMS_TO_TICKS(JOURNAL_LOTE_MS));
+        journal_commit(&journal);
+        if (journal_pending(&journal) == 0) {
+            journal_prepare(&journal);
+        } else {
+            xTaskNotifyGive(xTaskJournal);  // Commit falho: tenta de novo no próximo lote
         }
+    }
+}
+
+
+// Registra o evento na fila do consumidor e o acorda. Nada é perdido em
+// silêncio: com a fila cheia o evento entra em eventos_descartados.
+static void registra_evento(event_ring_t *fila, TaskHandle_t tarefa, uint gpio, uint8_t tipo,
+                            int pista, uint32_t agora, uint32_t irq_us) {
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    event_t ev = { .timestamp_us = agora, .irq_us = irq_us, .gpio = gpio, .kind = tipo,
+                   .lane = (uint8_t)pista };
+
+    bool aceito = event_ring_push(fila, &ev);
+    if (!aceito) eventos_descartados++;
+    TRACE_EVENTO_ISR(gpio, aceito);
+    TELEMETRIA_EVENTO(gpio, tipo, aceito, agora);
 
-        vTaskDelay(pdMS_TO_TICKS(100));
+    vTaskNotifyGiveFromISR(tarefa, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+
+// Encaminha uma borda já filtrada para a fila da pista (ou do reset). É o
+// callback do debounce por PIO, que entrega o instante da descida e o da
+// interrupção, e a entrada direta do modo de saturação da carga. A
+// latência até a tarefa é medida a partir de irq_us.
+void encaminha_evento(uint gpio, uint32_t timestamp, uint32_t irq_us) {
+    int pista = estacionamento_pista(gpio);
+
+    if (pista != EST_SEM_PISTA) {
+        if (estacionamento_pista_cfg(pista)->sentido == PISTA_ENTRADA) {
+            registra_evento(&fila_entrada, xTaskEntrada, gpio, EVENTO_ENTRADA, pista, timestamp, irq_us);
+        } else {
+            registra_evento(&fila_saida, xTaskSaida, gpio, EVENTO_SAIDA, pista, timestamp, irq_us);
+        }
+    }
+    else if (gpio == BUTTON_JOY) {
+        registra_evento(&fila_reset, xTaskReset, gpio, EVENTO_RESET, 0, timestamp, irq_us);
     }
 }
 
@@ -229,42 +509,38 @@ void vTaskLeds(void *params) {
 // Função de tratamento de interrupção dos botões
 void gpio_irq_handler(uint gpio, uint32_t events) {
     uint32_t current_time = to_us_since_boot(get_absolute_time());
+    int pista = estacionamento_pista(gpio);
 
-    if (gpio == BUTTON_B) {
-        if (current_time - last_time_B > DEBOUNCE_TIME) {
-            BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-            xSemaphoreGiveFromISR(xSemaforoSaida, &xHigherPriorityTaskWoken);
-            last_time_B = current_time;
-            portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
-            return;
-        }
-    }
-    else if (gpio == BUTTON_A) {
-        if (current_time - last_time_A > DEBOUNCE_TIME) {
-            BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-            xSemaphoreGiveFromISR(xSemaforoEntrada, &xHigherPriorityTaskWoken);
-            last_time_A = current_time;
-            portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    if (pista != EST_SEM_PISTA) {
+        if (current_time - ultimo_evento_pista[pista] > DEBOUNCE_TIME) {
+            encaminha_evento(gpio, current_time, current_time);
+            ultimo_evento_pista[pista] = current_time;
             return;
         }
     }
     else if (gpio == BUTTON_JOY) {
         if (current_time - last_time_joy > DEBOUNCE_TIME) {
-            BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-            xSemaphoreGiveFromISR(xSemaforoReset, &xHigherPriorityTaskWoken);
+            encaminha_evento(gpio, current_time, current_time);
             last_time_joy = current_time;
-            portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
             return;
         }
     }
 }
 
 
-// Inicializa GPIO para LEDs RGB
+// Inicializa GPIO para LEDs RGB (apagado)
 void init_gpio_led(uint gpio) {
+#if CONTROLE_VAGA_LED_PWM
+    uint slice = pwm_gpio_to_slice_num(gpio);
+    gpio_set_function(gpio, GPIO_FUNC_PWM);
+    pwm_set_wrap(slice, LED_NIVEL_MAX);
+    pwm_set_chan_level(slice, pwm_gpio_to_channel(gpio), 0);
+    pwm_set_enabled(slice, true);
+#else
     gpio_init(gpio);
     gpio_set_dir(gpio, GPIO_OUT);
     gpio_put(gpio, 0);
+#endif
 }
 
 
@@ -273,4 +549,5 @@ void init_gpio_button(uint gpio) {
     gpio_init(gpio);
     gpio_set_dir(gpio, GPIO_IN);
     gpio_pull_up(gpio);
-}
\ No newline at end of file
+}
+
@@ -8,30 +8,144 @@
 #include "hardware/i2c.h"
 #include "hardware/gpio.h"
 #include "hardware/clocks.h"
+#include "hardware/flash.h"
+#include "hardware/pwm.h"
 
 #include "FreeRTOS.h"
 #include "task.h"
 #include "semphr.h"
 
 #include "lib/ssd1306.h"
+#if CONTROLE_VAGA_DISPLAY_SPI
+#include "lib/ssd1306_spi.h"
+#else
+#include "lib/ssd1306_i2c.h"
+#endif
 #include "lib/buzzer.h"
+#include "lib/event_ring.h"
+#include "lib/journal.h"
+#if CONTROLE_VAGA_PIO_DEBOUNCE
+#include "lib/pio_debounce.h"
+#endif
+#include "admissao.h"
+#include "alocacao.h"
+#if CONTROLE_VAGA_CARGA
+#include "carga.h"
+#endif
+#include "display.h"
+#include "estacionamento.h"
+#include "vagas.h"
 
 #define I2C_PORT i2c1
 #define I2C_SDA 14
 #define I2C_SCL 15
 #define ENDERECO 0x3C
-ssd1306_t ssd;
+#ifndef CONTROLE_VAGA_I2C_HZ
+#define CONTROLE_VAGA_I2C_HZ 400000     // Clock do I2C do display (1000000 no modo rápido plus)
+#endif
+
+// Painel SPI de 4 fios (CONTROLE_VAGA_DISPLAY_SPI)
+#define SPI_PORT spi0
+#define SPI_SCK 18
+#define SPI_MOSI 19
+#define SPI_CS 17
+#define SPI_DC 20
+#define SPI_RES 16
+#define SPI_FREQ (10 * 1000 * 1000)
+
+#if CONTROLE_VAGA_BAIXO_CONSUMO
+#include "baixo_consumo.h"
+#define CLOCK_SISTEMA_KHZ BAIXO_CONSUMO_CLOCK_KHZ
+#else
+#define CLOCK_SISTEMA_KHZ 128000
+#endif
 
 #define BUTTON_A 5
 #define BUTTON_B 6
 #define BUTTON_JOY 22
 #define DEBOUNCE_TIME 300000        // Tempo para debounce em ms
-static uint32_t last_time_A = 0;    // Tempo da última interrupção do botão A
-static uint32_t last_time_B = 0;    // Tempo da última interrupção do botão B
+#define PIO_JANELA_US 20000         // Janela do debounce por PIO (CONTROLE_VAGA_PIO_DEBOUNCE)
 static uint32_t last_time_joy = 0;  // Tempo da última interrupção do botão do Joystick
 
 #define LED_RED_PIN 13
 #define LED_BLUE_PIN 12
 #define LED_GREEN_PIN 11
+#define LED_NIVEL_MAX 255           // Wrap do PWM dos LEDs (CONTROLE_VAGA_LED_PWM)
+
+// Cor do LED RGB, um nível por canal
+typedef struct {
+    uint8_t r, g, b;
+} cor_t;
+
+// Tipos de evento registrados pela ISR
+typedef enum {
+    EVENTO_ENTRADA,
+    EVENTO_SAIDA,
+    EVENTO_RESET,
+} tipo_evento_t;
+
+#define EVENTOS_POR_LOTE 8          // Eventos copiados da fila por vez
+
+// Pilhas das tarefas em palavras (ajuste pelo relatório de alocacao_relatorio)
+#define PILHA_EVENTOS (configMINIMAL_STACK_SIZE + 128)
+#define PILHA_LEDS (configMINIMAL_STACK_SIZE + 128)
+#define PILHA_JOURNAL (configMINIMAL_STACK_SIZE + 128)
+
+// Journal da ocupação nos últimos setores da flash (fora do programa)
+#define JOURNAL_SETORES 16
+#define JOURNAL_OFFSET (PICO_FLASH_SIZE_BYTES - JOURNAL_SETORES * FLASH_SECTOR_SIZE)
+#define JOURNAL_LOTE_MS 250         // Espera para juntar registros num só commit
+
+// Estado exposto para o benchmark do host
+extern uint32_t eventos_descartados;   // Eventos perdidos com a fila cheia
+extern event_ring_t fila_entrada;
+extern event_ring_t fila_saida;
+extern event_ring_t fila_reset;
+
+// Núcleos usados no modo SMP (CONTROLE_VAGA_SMP)
+#define NUCLEO_EVENTOS 0        // Mesmo núcleo que registra a IRQ dos botões
+#define NUCLEO_IO 1             // Display, LEDs e buzzer
+
+// Ganchos de rastreamento de eventos (ligados aos benchmarks do host e da placa)
+#if defined(CONTROLE_VAGA_HOST)
+#include "host_trace.h"
+#elif CONTROLE_VAGA_BENCH
+#include "bench_latencia.h"
+#elif CONTROLE_VAGA_METRICAS
+#include "metricas.h"
+#else
+#define TRACE_EVENTO_ISR(gpio, aceito)
+#define TRACE_EVENTO_TAREFA(gpio, irq_us)
+#endif
+
+// Estatísticas de ocupação (CONTROLE_VAGA_ANALISE)
+#if CONTROLE_VAGA_ANALISE
+#include "analise.h"
+#else
+#define ANALISE_ENTRADA(lote)
+#define ANALISE_SAIDA(lote)
+#define ANALISE_RESET()
+#endif
+
+// Registros de telemetria binária (CONTROLE_VAGA_TELEMETRIA)
+#if CONTROLE_VAGA_TELEMETRIA
+#include "telemetria.h"
+#else
+#define TELEMETRIA_EVENTO(gpio, tipo, aceito, timestamp_us)
+#define TELEMETRIA_OCUPACAO(lote, delta, ocupadas)
+#define TELEMETRIA_LATENCIA(gpio, irq_us)
+#endif
+
+// Status da ocupação pela rede (CONTROLE_VAGA_REDE)
+#if CONTROLE_VAGA_REDE
+#include "rede.h"
+#else
+#define REDE_MUDOU()
+#endif
+
+bool controle_vaga_init(void);
+void controle_vaga_journal_stats(journal_stats_t *stats);
+void gpio_irq_handler(uint gpio, uint32_t events);
+void encaminha_evento(uint gpio, uint32_t timestamp, uint32_t irq_us);  // Sem debounce (contexto de interrupção)
 
 #endif
\ No newline at end of file
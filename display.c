@@ -0,0 +1,267 @@
+/*
+ *  Tarefa de render: única dona do SSD1306. As demais tarefas só postam o
+ *  estado da tela numa fila; o render desenha apenas o estado mais recente,
+ *  no máximo uma vez a cada DISPLAY_FRAME_MS.
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "timers.h"
+
+#include "admissao.h"
+#include "alocacao.h"
+#if CONTROLE_VAGA_ANALISE
+#include "analise.h"
+#endif
+#include "display.h"
+#include "estacionamento.h"
+#include "vagas.h"
+#include "telas.h"              // Gerado por tools/gera_telas.py
+
+static ssd1306_t ssd;
+#if CONTROLE_VAGA_ESTATICO
+static ssd1306_buffers_t ssd_buffers;
+#endif
+static QueueHandle_t xDisplayQueue;
+static TimerHandle_t xTimerEspera;
+static TaskHandle_t xTaskDisplay;
+static display_stats_t stats;      // frames: só o render escreve
+// Postados por várias tarefas e pelo timer daemon, nos dois núcleos no SMP
+static _Atomic uint32_t pedidos, coalescidos;
+
+static void vTaskDisplay(void *params);
+static void display_timer_espera(TimerHandle_t timer);
+
+
+// Configura o SSD1306, mostra a tela inicial e cria a tarefa de render
+void display_init(const ssd1306_bus_t *barramento) {
+#if CONTROLE_VAGA_ESTATICO
+    ssd1306_init_static(&ssd, &ssd_buffers, WIDTH, HEIGHT, false, barramento);
+#else
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, barramento);
+#endif
+    ssd1306_config(&ssd);
+    ssd1306_send_data(&ssd);
+
+    CRIA_FILA(xDisplayQueue, DISPLAY_FILA, display_msg_t);
+    CRIA_TIMER(xTimerEspera, "TelaEspera", pdMS_TO_TICKS(DISPLAY_RESULTADO_MS), pdFALSE, NULL,
+               display_timer_espera);
+    CRIA_TAREFA(xTaskDisplay, vTaskDisplay, "DisplayTask", DISPLAY_PILHA, 1);
+    display_post(TELA_ESPERA, 0, 0);
+}
+
+
+// Pede uma tela sem bloquear. Com a fila cheia a mensagem mais antiga é
+// descartada: ela seria coalescida de qualquer forma. Telas de resultado
+// (re)iniciam o timer que volta à tela de espera, então eventos seguidos
+// mantêm o resultado mais recente visível sem atrasar quem posta.
+static bool display_envia(const display_msg_t *msg) {
+    display_msg_t antiga;
+
+    if (msg->tela == TELA_ANALISE) {
+        xTimerChangePeriod(xTimerEspera, pdMS_TO_TICKS(DISPLAY_PAGINA_MS), 0);
+    } else if (msg->tela != TELA_ESPERA) {
+        xTimerChangePeriod(xTimerEspera, pdMS_TO_TICKS(DISPLAY_RESULTADO_MS), 0);
+    }
+
+    atomic_fetch_add_explicit(&pedidos, 1, memory_order_relaxed);
+    if (xQueueSend(xDisplayQueue, msg, 0) == pdTRUE) {
+        return true;
+    }
+    if (xQueueReceive(xDisplayQueue, &antiga, 0) == pdTRUE) {
+        atomic_fetch_add_explicit(&coalescidos, 1, memory_order_relaxed);
+    }
+    return xQueueSend(xDisplayQueue, msg, 0) == pdTRUE;
+}
+
+
+bool display_post(tela_t tela, uint8_t lote, uint16_t eventos) {
+    display_msg_t msg = { .tela = tela, .lote = lote, .eventos = eventos, .vaga = VAGAS_NENHUMA };
+    return display_envia(&msg);
+}
+
+
+// Carro admitido: ocupação e a vaga para onde ele deve ir
+bool display_post_entrada(uint8_t lote, uint16_t ocupadas, int16_t vaga) {
+    display_msg_t msg = { .tela = TELA_ENTRADA, .lote = lote, .eventos = ocupadas, .vaga = vaga };
+    return display_envia(&msg);
+}
+
+
+// Carro na fila de admissão: posição e espera estimada
+bool display_post_fila(uint8_t lote, uint8_t posicao, uint32_t espera_ms) {
+    display_msg_t msg = { .tela = TELA_FILA, .lote = lote, .eventos = posicao, .espera_ms = espera_ms,
+                          .vaga = VAGAS_NENHUMA };
+    return display_envia(&msg);
+}
+
+
+// Roda na tarefa de timers do FreeRTOS
+static void display_timer_espera(TimerHandle_t timer) {
+    display_post(TELA_ESPERA, 0, 0);
+}
+
+
+void display_stats(display_stats_t *out) {
+    *out = stats;
+    out->pedidos = atomic_load_explicit(&pedidos, memory_order_relaxed);
+    out->coalescidos = atomic_load_explicit(&coalescidos, memory_order_relaxed);
+}
+
+
+TaskHandle_t display_task(void) {
+    return xTaskDisplay;
+}
+
+
+// Tela de espera já desenhada e enviada: nada mais vai acontecer sem evento
+bool display_ocioso(void) {
+    return !ssd1306_busy(&ssd) && uxQueueMessagesWaiting(xDisplayQueue) == 0 &&
+           !xTimerIsTimerActive(xTimerEspera);
+}
+
+
+const ssd1306_stats_t *display_ssd_stats(void) {
+    return &ssd.stats;
+}
+
+
+// Uma linha "nome ocupadas/capacidade" por lote, lida direto dos contadores,
+// com "+N" quando há carros na fila de admissão
+static void display_desenha_lotes(void) {
+    char buffer[32];
+    lote_resumo_t lote;
+    admissao_resumo_t fila;
+
+    for (size_t i = 0; i < estacionamento_num_lotes(); i++) {
+        estacionamento_resumo((uint8_t)i, &lote);
+        admissao_resumo((uint8_t)i, &fila);
+        int n = snprintf(buffer, sizeof(buffer), "%-7.7s %2u/%u", lote.nome, lote.ocupadas, lote.capacidade);
+        if (fila.tamanho) {
+            snprintf(buffer + n, sizeof(buffer) - n, " +%u", fila.tamanho);
+        }
+        ssd1306_draw_string(&ssd, buffer, TELA_LOTES_X, TELA_LOTES_Y + 10 * i);
+    }
+}
+
+
+// Posição na fila e espera estimada ("--" antes da segunda saída do lote)
+static void display_desenha_espera(const display_msg_t *msg) {
+    char buffer[32];
+    uint32_t espera_s = msg->espera_ms / 1000u;
+
+    snprintf(buffer, sizeof(buffer), "%u/%u", msg->eventos, ADMISSAO_MAX);
+    ssd1306_draw_string(&ssd, buffer, TELA_POSICAO_X, TELA_POSICAO_Y);
+    if (msg->espera_ms == ADMISSAO_SEM_ESTIMATIVA) {
+        snprintf(buffer, sizeof(buffer), "--");
+    } else if (espera_s < 100) {
+        snprintf(buffer, sizeof(buffer), "%us", (unsigned)espera_s);
+    } else {
+        snprintf(buffer, sizeof(buffer), "%umin", (unsigned)((espera_s + 30) / 60));
+    }
+    ssd1306_draw_string(&ssd, buffer, TELA_ESPERA_X, TELA_ESPERA_Y);
+}
+
+
+#if CONTROLE_VAGA_ANALISE
+// Médias de 15 e 60 minutos e uma barra por minuto da última hora, com a
+// altura proporcional à capacidade total
+static void display_desenha_analise(void) {
+    static analise_resumo_t resumo;
+    static uint16_t serie[ANALISE_BALDES];
+    const uint8_t altura = HEIGHT - TELA_GRAFICO_Y;
+    char buffer[32];
+    uint16_t capacidade;
+
+    analise_resumo(&resumo);
+    snprintf(buffer, sizeof(buffer), "15m %.1f 1h %.1f", resumo.janelas[1].media, resumo.janelas[2].media);
+    ssd1306_draw_string(&ssd, buffer, TELA_MEDIAS_X, TELA_MEDIAS_Y);
+
+    estacionamento_total(&capacidade);
+    size_t n = analise_serie(serie, ANALISE_BALDES);
+    uint8_t x = TELA_GRAFICO_X + 2 * (ANALISE_BALDES - n);     // Alinhado à direita
+    for (size_t i = 0; i < n; i++, x += 2) {
+        uint32_t h = capacidade ? (uint32_t)serie[i] * altura / (capacidade * 10u) : 0;
+        if (h > altura) h = altura;
+        if (h) ssd1306_rect(&ssd, HEIGHT - h, x, 2, h, true, true);
+    }
+    ssd1306_hline(&ssd, TELA_GRAFICO_X, TELA_GRAFICO_X + 2 * ANALISE_BALDES - 1, HEIGHT - 1, true);
+}
+#endif
+
+
+// Os textos fixos vêm prontos (telas.h); só lotes e contadores são desenhados
+static void display_desenha(const display_msg_t *msg) {
+    char buffer[32];
+    lote_resumo_t lote;
+
+    switch (msg->tela) {
+        case TELA_ESPERA:
+            ssd1306_blit(&ssd, tela_espera);
+            display_desenha_lotes();
+            return;
+        case TELA_ENTRADA:
+            ssd1306_blit(&ssd, tela_entrada);
+            break;
+        case TELA_SAIDA:
+            ssd1306_blit(&ssd, tela_saida);
+            break;
+        case TELA_RESET:
+            ssd1306_blit(&ssd, tela_reset);
+            return;
+        case TELA_FILA:
+            ssd1306_blit(&ssd, tela_fila);
+            display_desenha_espera(msg);
+            break;
+        case TELA_ANALISE:
+#if CONTROLE_VAGA_ANALISE
+            ssd1306_blit(&ssd, tela_analise);
+            display_desenha_analise();
+#endif
+            return;
+    }
+    estacionamento_resumo(msg->lote, &lote);
+    snprintf(buffer, sizeof(buffer), "%.8s", lote.nome);
+    ssd1306_draw_string(&ssd, buffer, TELA_LOTE_X, TELA_LOTE_Y);
+    if (msg->tela == TELA_FILA) return;
+    snprintf(buffer, sizeof(buffer), "%u/%u", msg->eventos, lote.capacidade);
+    ssd1306_draw_string(&ssd, buffer, TELA_EVENTOS_X, TELA_EVENTOS_Y);
+    if (msg->vaga != VAGAS_NENHUMA) {
+        char rotulo[VAGAS_ROTULO];
+        vagas_rotulo(msg->lote, msg->vaga, rotulo, sizeof(rotulo));
+        snprintf(buffer, sizeof(buffer), "Vaga: %s", rotulo);
+        ssd1306_draw_string(&ssd, buffer, TELA_VAGA_X, TELA_VAGA_Y);
+    }
+}
+
+
+static void vTaskDisplay(void *params) {
+    display_msg_t msg;
+    TickType_t ultimo_frame = xTaskGetTickCount() - pdMS_TO_TICKS(DISPLAY_FRAME_MS);
+
+    while (true) {
+        if (xQueueReceive(xDisplayQueue, &msg, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        // Respeita o orçamento de quadro; o que chegar enquanto isso é coalescido
+        TickType_t decorrido = xTaskGetTickCount() - ultimo_frame;
+        if (decorrido < pdMS_TO_TICKS(DISPLAY_FRAME_MS)) {
+            vTaskDelay(pdMS_TO_TICKS(DISPLAY_FRAME_MS) - decorrido);
+        }
+        while (xQueueReceive(xDisplayQueue, &msg, 0) == pdTRUE) {
+            atomic_fetch_add_explicit(&coalescidos, 1, memory_order_relaxed);
+        }
+
+        // Publica o frame e segue: o próximo é desenhado no back buffer
+        // enquanto este ainda sai pelo barramento
+        display_desenha(&msg);
+        ssd1306_swap(&ssd, NULL, NULL);
+        stats.frames++;
+        ultimo_frame = xTaskGetTickCount();
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include "pico/stdlib.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "lib/ssd1306.h"
+
+// Intervalo mínimo entre duas atualizações do display
+#ifndef DISPLAY_FRAME_MS
+#define DISPLAY_FRAME_MS 50
+#endif
+
+// Tempo que uma tela de resultado fica visível antes de voltar à de espera
+#ifndef DISPLAY_RESULTADO_MS
+#define DISPLAY_RESULTADO_MS 1500
+#endif
+
+// Tempo da página de estatísticas (TELA_ANALISE)
+#ifndef DISPLAY_PAGINA_MS
+#define DISPLAY_PAGINA_MS 10000
+#endif
+
+#define DISPLAY_FILA 8      // Mensagens pendentes antes de descartar as mais antigas
+#define DISPLAY_PILHA (configMINIMAL_STACK_SIZE + 128)
+
+// Telas que as tarefas podem pedir ao render
+typedef enum {
+    TELA_ESPERA,
+    TELA_ENTRADA,
+    TELA_SAIDA,
+    TELA_RESET,
+    TELA_FILA,
+    TELA_ANALISE,           // Página de estatísticas (CONTROLE_VAGA_ANALISE)
+} tela_t;
+
+typedef struct {
+    tela_t tela;
+    uint8_t lote;           // Lote do evento (telas de entrada, saída e fila)
+    uint16_t eventos;       // Ocupadas, ou a posição na fila
+    uint32_t espera_ms;     // Espera estimada na fila (ADMISSAO_SEM_ESTIMATIVA)
+    int16_t vaga;           // Vaga atribuída na entrada (VAGAS_NENHUMA)
+} display_msg_t;
+
+typedef struct {
+    uint32_t pedidos;       // Mensagens postadas
+    uint32_t coalescidos;   // Mensagens substituídas por uma mais nova antes de desenhar
+    uint32_t frames;        // Telas efetivamente desenhadas
+} display_stats_t;
+
+void display_init(const ssd1306_bus_t *barramento);
+bool display_post(tela_t tela, uint8_t lote, uint16_t eventos);
+bool display_post_entrada(uint8_t lote, uint16_t ocupadas, int16_t vaga);
+bool display_post_fila(uint8_t lote, uint8_t posicao, uint32_t espera_ms);
+void display_stats(display_stats_t *stats);
+TaskHandle_t display_task(void);
+bool display_ocioso(void);
+const ssd1306_stats_t *display_ssd_stats(void);
+
+#endif
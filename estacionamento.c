@@ -0,0 +1,150 @@
+/*
+ *  Ocupação por lote com contadores atômicos.
+ *
+ *  O contador é o único dono da ocupação do lote. Entradas e saídas fazem
+ *  um laço de compare-and-swap sobre ele, e os leitores (resumo e total)
+ *  não pegam trava. A admissao.c chama entra e sai com a trava do lote
+ *  dela, que só existe para a fila e o mapa de vagas mudarem junto com o
+ *  contador; lotes diferentes não disputam nada aqui. No RP2040
+ *  (Cortex-M0+, sem LDREX/STREX) a pico_atomic faz cada operação atômica
+ *  com um spinlock de hardware e as interrupções desligadas, por alguns
+ *  ciclos.
+ */
+
+#include "estacionamento.h"
+
+#define EST_NUM_GPIOS 32
+
+typedef struct {
+    const char *nome;
+    uint16_t capacidade;
+    _Atomic uint32_t ocupadas;
+    _Atomic uint32_t recusas;
+} lote_t;
+
+static lote_t lotes[EST_MAX_LOTES];
+static size_t num_lotes;
+static pista_cfg_t pistas[EST_MAX_PISTAS];
+static size_t num_pistas;
+static int8_t pista_do_gpio[EST_NUM_GPIOS];    // Consulta direta na ISR
+
+
+// Copia as tabelas; falha se uma pista aponta para um lote inexistente
+bool estacionamento_init(const lote_cfg_t *cfg_lotes, size_t n_lotes,
+                         const pista_cfg_t *cfg_pistas, size_t n_pistas) {
+    if (n_lotes == 0 || n_lotes > EST_MAX_LOTES || n_pistas > EST_MAX_PISTAS) {
+        return false;
+    }
+
+    for (size_t i = 0; i < EST_NUM_GPIOS; i++) {
+        pista_do_gpio[i] = EST_SEM_PISTA;
+    }
+    for (size_t i = 0; i < n_lotes; i++) {
+        lotes[i].nome = cfg_lotes[i].nome;
+        lotes[i].capacidade = cfg_lotes[i].capacidade;
+        atomic_store_explicit(&lotes[i].ocupadas, 0, memory_order_relaxed);
+        atomic_store_explicit(&lotes[i].recusas, 0, memory_order_relaxed);
+    }
+    for (size_t i = 0; i < n_pistas; i++) {
+        if (cfg_pistas[i].lote >= n_lotes || cfg_pistas[i].gpio >= EST_NUM_GPIOS) {
+            return false;
+        }
+        pistas[i] = cfg_pistas[i];
+        pista_do_gpio[cfg_pistas[i].gpio] = (int8_t)i;
+    }
+    num_lotes = n_lotes;
+    num_pistas = n_pistas;
+    return true;
+}
+
+
+// Pista ligada ao GPIO, ou EST_SEM_PISTA
+int estacionamento_pista(uint gpio) {
+    return gpio < EST_NUM_GPIOS ? pista_do_gpio[gpio] : EST_SEM_PISTA;
+}
+
+const pista_cfg_t *estacionamento_pista_cfg(int pista) {
+    return &pistas[pista];
+}
+
+size_t estacionamento_num_pistas(void) {
+    return num_pistas;
+}
+
+size_t estacionamento_num_lotes(void) {
+    return num_lotes;
+}
+
+
+// Ocupa uma vaga se o lote não estiver cheio
+bool estacionamento_entra(uint8_t lote, uint16_t *ocupadas) {
+    lote_t *l = &lotes[lote];
+    uint32_t atual = atomic_load_explicit(&l->ocupadas, memory_order_relaxed);
+
+    do {
+        if (atual >= l->capacidade) {
+            *ocupadas = (uint16_t)atual;
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&l->ocupadas, &atual, atual + 1,
+                                                    memory_order_acq_rel, memory_order_relaxed));
+
+    *ocupadas = (uint16_t)(atual + 1);
+    return true;
+}
+
+
+// Entrada negada: lote cheio e sem lugar na fila de admissão
+void estacionamento_recusa(uint8_t lote) {
+    atomic_fetch_add_explicit(&lotes[lote].recusas, 1, memory_order_relaxed);
+}
+
+
+// Libera uma vaga se houver alguma ocupada
+bool estacionamento_sai(uint8_t lote, uint16_t *ocupadas) {
+    lote_t *l = &lotes[lote];
+    uint32_t atual = atomic_load_explicit(&l->ocupadas, memory_order_relaxed);
+
+    do {
+        if (atual == 0) {
+            *ocupadas = 0;
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&l->ocupadas, &atual, atual - 1,
+                                                    memory_order_acq_rel, memory_order_relaxed));
+
+    *ocupadas = (uint16_t)(atual - 1);
+    return true;
+}
+
+
+// Estado restaurado na partida, ou zero no reset (limitado à capacidade
+// atual do lote)
+void estacionamento_define(uint8_t lote, uint16_t ocupadas) {
+    lote_t *l = &lotes[lote];
+    atomic_store_explicit(&l->ocupadas, ocupadas < l->capacidade ? ocupadas : l->capacidade,
+                          memory_order_release);
+}
+
+
+void estacionamento_resumo(uint8_t lote, lote_resumo_t *out) {
+    const lote_t *l = &lotes[lote];
+
+    out->nome = l->nome;
+    out->capacidade = l->capacidade;
+    out->ocupadas = (uint16_t)atomic_load_explicit(&l->ocupadas, memory_order_acquire);
+    out->recusas = atomic_load_explicit(&l->recusas, memory_order_relaxed);
+}
+
+
+// Soma de todos os lotes (para os LEDs)
+uint16_t estacionamento_total(uint16_t *capacidade) {
+    uint32_t ocupadas = 0, total = 0;
+
+    for (size_t i = 0; i < num_lotes; i++) {
+        ocupadas += atomic_load_explicit(&lotes[i].ocupadas, memory_order_acquire);
+        total += lotes[i].capacidade;
+    }
+    *capacidade = (uint16_t)total;
+    return (uint16_t)ocupadas;
+}
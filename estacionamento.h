@@ -0,0 +1,61 @@
+#ifndef ESTACIONAMENTO_H
+#define ESTACIONAMENTO_H
+
+// Tabela de lotes e pistas: qualquer GPIO pode ser uma pista de entrada ou
+// de saída, e cada pista pertence a um lote com capacidade própria. A
+// ocupação de cada lote é um contador atômico, o único lugar onde ela fica.
+// A admissao.c chama entra e sai com a trava do lote, que mantém a fila e o
+// mapa de vagas de acordo com o contador; as leituras não travam.
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "pico/stdlib.h"
+
+#define EST_MAX_LOTES 4             // Cabem quatro linhas de resumo no display
+#define EST_MAX_PISTAS 8
+#define EST_SEM_PISTA (-1)
+
+typedef enum {
+    PISTA_ENTRADA,
+    PISTA_SAIDA,
+} sentido_t;
+
+typedef struct {
+    const char *nome;
+    uint16_t capacidade;
+    uint8_t niveis;                 // Vagas divididas em níveis (0 = um só)
+    uint8_t zonas;                  // Zonas por nível, A a Z (0 = uma só)
+} lote_cfg_t;
+
+typedef struct {
+    uint gpio;
+    uint8_t lote;                   // Índice na tabela de lotes
+    sentido_t sentido;
+} pista_cfg_t;
+
+typedef struct {
+    const char *nome;
+    uint16_t capacidade;
+    uint16_t ocupadas;
+    uint32_t recusas;               // Entradas negadas com o lote e a fila cheios
+} lote_resumo_t;
+
+bool estacionamento_init(const lote_cfg_t *lotes, size_t n_lotes,
+                         const pista_cfg_t *pistas, size_t n_pistas);
+int estacionamento_pista(uint gpio);
+const pista_cfg_t *estacionamento_pista_cfg(int pista);
+size_t estacionamento_num_pistas(void);
+size_t estacionamento_num_lotes(void);
+
+bool estacionamento_entra(uint8_t lote, uint16_t *ocupadas);
+void estacionamento_recusa(uint8_t lote);
+bool estacionamento_sai(uint8_t lote, uint16_t *ocupadas);
+void estacionamento_define(uint8_t lote, uint16_t ocupadas);
+
+void estacionamento_resumo(uint8_t lote, lote_resumo_t *out);
+uint16_t estacionamento_total(uint16_t *capacidade);
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ *  Benchmark de capacidade com tráfego sintético no host.
+ *
+ *  Roda um perfil do gerador de carga (carga.c) pelo gpio_irq_handler e, no
+ *  fim, compara a ocupação de cada lote com a esperada, além de eventos/s
+ *  sustentados, esperas nas cancelas e descartes nas filas de eventos.
+ *  Cada borda injetada tem de ser aceita ou recusada pela fila, cada recusa
+ *  contada em eventos_descartados e cada aceita tratada por uma tarefa. O
+ *  perfil saturacao tem de produzir descartes.
+ *
+ *  Uso: bench_carga [perfil] [duracao_s] [semente]
+ *  Perfis: pico, rajada, tempestade, saturacao
+ */
+
+#include <stdlib.h>
+
+#include "controle_vaga.h"
+#include "carga.h"
+#include "hal_host.h"
+
+static const carga_cfg_t *perfil;
+static uint32_t duracao_s = 30;
+static uint32_t semente = 1;
+static uint32_t aceitos, recusados, tratados;
+
+
+void bench_trace_isr(uint gpio, bool aceito) {
+    if (aceito) {
+        aceitos++;
+    } else {
+        recusados++;
+    }
+}
+
+void bench_trace_tarefa(uint gpio, uint32_t irq_us) {
+    tratados++;
+}
+
+
+// Faz o papel do alarme da placa: dorme até o próximo passo do gerador
+static void vTaskCargaHost(void *params) {
+    // Deixa passar a janela de debounce inicial e a tela de espera
+    vTaskDelay(pdMS_TO_TICKS(DEBOUNCE_TIME / 1000 + 100));
+
+    uint64_t agora = time_us_64();
+    uint64_t fim = agora + (uint64_t)duracao_s * 1000000u;
+    carga_inicia(perfil, semente, agora);
+
+    while ((agora = time_us_64()) < fim) {
+        uint64_t proximo = carga_passo(agora);
+        if (proximo > fim) proximo = fim;
+        if (proximo > agora) {
+            vTaskDelay(pdMS_TO_TICKS((proximo - agora + 999) / 1000));
+        }
+    }
+    carga_para();
+
+    carga_resultado_t resultado;
+    carga_resultado(&resultado);
+    carga_imprime(&resultado);
+    printf("[carga] isr: %u aceitos, %u recusados; tarefas: %u tratados (%.2f eventos/s)\n",
+           aceitos, recusados, tratados, tratados / (resultado.duracao_us / 1e6));
+
+    bool confere = true;
+    for (size_t i = 0; i < resultado.num_lotes; i++) {
+        confere &= resultado.ocupadas[i] == resultado.verdade[i] &&
+                   resultado.recusas[i] == resultado.recusas_verdade[i];
+    }
+    bool contagem = aceitos + recusados == resultado.injetados && recusados == resultado.descartados &&
+                    resultado.descartes_vistos == resultado.descartados && tratados == aceitos;
+    if (!contagem) {
+        printf("[carga] contagem de eventos DIVERGE\n");
+    }
+    if (perfil->modo == CARGA_SATURACAO && resultado.descartados == 0) {
+        printf("[carga] saturacao sem descartes\n");
+        contagem = false;
+    }
+    exit(confere && contagem ? 0 : 1);
+}
+
+
+int main(int argc, char **argv) {
+    perfil = carga_perfil(argc > 1 ? argv[1] : "pico");
+    if (argc > 2) duracao_s = (uint32_t)strtoul(argv[2], NULL, 10);
+    if (argc > 3) semente = (uint32_t)strtoul(argv[3], NULL, 10);
+    if (!perfil) {
+        printf("Perfis: pico, rajada, tempestade, saturacao\n");
+        return 2;
+    }
+
+    stdio_init_all();
+    if (!controle_vaga_init()) {
+        return 1;
+    }
+
+    TaskHandle_t tarefa;
+    CRIA_TAREFA(tarefa, vTaskCargaHost, "CargaTask", CARGA_PILHA, configMAX_PRIORITIES - 2);
+    vTaskStartScheduler();
+    return 0;
+}
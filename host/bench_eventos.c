@@ -0,0 +1,165 @@
+/*
+ *  Benchmark de vazão do controle de vagas no host.
+ *
+ *  Injeta interrupções dos botões pelo gpio_irq_handler registrado e mede
+ *  eventos/s tratados pelas tarefas, a latência ISR -> tarefa (pelo instante
+ *  gravado em cada registro da fila de eventos) e os descartes.
+ *
+ *  Uso: bench_eventos [duracao_s] [intervalo_ms] [reset_ms]
+ */
+
+#include <stdlib.h>
+
+#include "controle_vaga.h"
+#include "hal_host.h"
+
+#define BENCH_PORTAS 3
+#define BENCH_MAX_AMOSTRAS 65536
+
+typedef struct {
+    uint gpio;
+    const char *nome;
+    event_ring_t *fila;
+    uint32_t injetados, aceitos, descartados, processados;
+} bench_porta_t;
+
+static bench_porta_t portas[BENCH_PORTAS] = {
+    { .gpio = BUTTON_A,   .nome = "entrada", .fila = &fila_entrada },
+    { .gpio = BUTTON_B,   .nome = "saida",   .fila = &fila_saida },
+    { .gpio = BUTTON_JOY, .nome = "reset",   .fila = &fila_reset },
+};
+
+static uint32_t amostras[BENCH_MAX_AMOSTRAS];
+static uint32_t num_amostras;
+
+static uint32_t duracao_s = 10;
+static uint32_t intervalo_ms = 350;
+static uint32_t reset_ms = 0;
+
+
+static bench_porta_t *porta_do_gpio(uint gpio) {
+    for (int i = 0; i < BENCH_PORTAS; i++) {
+        if (portas[i].gpio == gpio) return &portas[i];
+    }
+    return NULL;
+}
+
+void bench_trace_isr(uint gpio, bool aceito) {
+    bench_porta_t *p = porta_do_gpio(gpio);
+    if (!p) return;
+
+    if (aceito) {
+        p->aceitos++;
+    } else {
+        p->descartados++;
+    }
+}
+
+// O registro da fila traz o instante da ISR, então a latência sai direto
+void bench_trace_tarefa(uint gpio, uint32_t irq_us) {
+    bench_porta_t *p = porta_do_gpio(gpio);
+    if (!p) return;
+
+    p->processados++;
+    if (num_amostras < BENCH_MAX_AMOSTRAS) {
+        amostras[num_amostras++] = time_us_32() - irq_us;
+    }
+}
+
+
+static int compara_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t percentil(uint32_t p) {
+    if (num_amostras == 0) return 0;
+    uint32_t i = (uint32_t)(((uint64_t)num_amostras * p) / 100u);
+    return amostras[i < num_amostras ? i : num_amostras - 1];
+}
+
+static void bench_relatorio(uint64_t tempo_us) {
+    host_i2c_stats_t i2c;
+    host_i2c_stats(&i2c);
+    qsort(amostras, num_amostras, sizeof(amostras[0]), compara_u32);
+
+    uint32_t processados = 0;
+    printf("\n=== bench_eventos: %.1f s, intervalo %u ms ===\n", tempo_us / 1e6, intervalo_ms);
+    printf("%-8s %10s %10s %10s %10s %10s %10s\n", "porta", "injetados", "aceitos", "descart.",
+           "tratados", "pendentes", "pico fila");
+    for (int i = 0; i < BENCH_PORTAS; i++) {
+        bench_porta_t *p = &portas[i];
+        printf("%-8s %10u %10u %10u %10u %10u %10u\n", p->nome, p->injetados, p->aceitos,
+               p->descartados, p->processados, p->aceitos - p->processados, p->fila->high_water);
+        processados += p->processados;
+    }
+    printf("vazao:        %.2f eventos/s\n", processados / (tempo_us / 1e6));
+    printf("latencia us:  p50 %u  p90 %u  p99 %u  max %u  (%u amostras)\n",
+           percentil(50), percentil(90), percentil(99), percentil(100), num_amostras);
+    printf("descartados:  %u (contador do firmware)\n", eventos_descartados);
+    for (size_t i = 0; i < estacionamento_num_lotes(); i++) {
+        lote_resumo_t lote;
+        estacionamento_resumo((uint8_t)i, &lote);
+        printf("lote %-7s  %u/%u ocupadas, %u recusas\n", lote.nome, lote.ocupadas,
+               lote.capacidade, lote.recusas);
+    }
+    printf("i2c:          %u transacoes, %llu bytes, %.1f ms de barramento\n",
+           i2c.transacoes, (unsigned long long)i2c.bytes, i2c.tempo_us / 1e3);
+    const ssd1306_stats_t *oled = display_ssd_stats();
+    display_stats_t render;
+    display_stats(&render);
+    printf("display:      %u frames, %.0f bytes/frame e %.0f us/frame em media (max %u us)\n",
+           oled->frames, oled->frames ? (double)oled->total_bytes / oled->frames : 0.0,
+           oled->frames ? (double)oled->total_us / oled->frames : 0.0, oled->max_frame_us);
+    printf("render:       %u pedidos, %u coalescidos, %u desenhados\n",
+           render.pedidos, render.coalescidos, render.frames);
+}
+
+
+// Gera as bordas de descida dos botões em intervalos fixos
+static void vTaskBench(void *params) {
+    // Deixa passar a janela de debounce inicial e a tela de espera
+    vTaskDelay(pdMS_TO_TICKS(DEBOUNCE_TIME / 1000 + 100));
+
+    uint64_t inicio = time_us_64();
+    uint64_t fim = inicio + (uint64_t)duracao_s * 1000000u;
+    uint64_t proximo_reset = inicio + (uint64_t)reset_ms * 1000u;
+    TickType_t ultimo = xTaskGetTickCount();
+
+    while (time_us_64() < fim) {
+        portas[0].injetados++;
+        host_gpio_trigger(BUTTON_A, GPIO_IRQ_EDGE_FALL);
+        vTaskDelayUntil(&ultimo, pdMS_TO_TICKS(intervalo_ms / 2));
+
+        portas[1].injetados++;
+        host_gpio_trigger(BUTTON_B, GPIO_IRQ_EDGE_FALL);
+        vTaskDelayUntil(&ultimo, pdMS_TO_TICKS(intervalo_ms - intervalo_ms / 2));
+
+        if (reset_ms && time_us_64() >= proximo_reset) {
+            portas[2].injetados++;
+            host_gpio_trigger(BUTTON_JOY, GPIO_IRQ_EDGE_FALL);
+            proximo_reset += (uint64_t)reset_ms * 1000u;
+        }
+    }
+
+    bench_relatorio(time_us_64() - inicio);
+    exit(0);
+}
+
+
+int main(int argc, char **argv) {
+    if (argc > 1) duracao_s = (uint32_t)strtoul(argv[1], NULL, 10);
+    if (argc > 2) intervalo_ms = (uint32_t)strtoul(argv[2], NULL, 10);
+    if (argc > 3) reset_ms = (uint32_t)strtoul(argv[3], NULL, 10);
+
+    stdio_init_all();
+    if (!controle_vaga_init()) {
+        return 1;
+    }
+    host_i2c_stats_reset();
+
+    TaskHandle_t tarefa;
+    CRIA_TAREFA(tarefa, vTaskBench, "BenchTask", configMINIMAL_STACK_SIZE, configMAX_PRIORITIES - 2);
+    vTaskStartScheduler();
+    return 0;
+}
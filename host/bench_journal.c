@@ -0,0 +1,207 @@
+/*
+ *  Simulação do journal de ocupação sobre a flash simulada do host.
+ *
+ *  Aplica entradas, saídas e resets aleatórios em vários lotes, grava em
+ *  lotes de tamanho aleatório e corta a energia em pontos aleatórios, no
+ *  meio de gravações e de apagamentos. Depois de cada corte o journal é
+ *  montado de novo e o estado restaurado precisa ser o de algum prefixo do
+ *  lote que estava sendo gravado. Informa o tempo de restauração, quantos
+ *  registros foram reexecutados e o desgaste por setor.
+ *
+ *  Depois, numa flash nova, acrescenta mais registros do que cabem na área
+ *  de preparo e faz gravações falharem sem corte de energia: o estado
+ *  montado no fim tem que ser o de todos os registros acrescentados.
+ *
+ *  Uso: bench_journal [eventos] [setores] [semente]
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hal_host.h"
+
+#define BENCH_CHAVES 4
+#define BENCH_CHANCE_CORTE 40       // Um corte a cada ~40 commits
+
+static journal_flash_t flash;
+static journal_t journal;
+static int32_t modelo[BENCH_CHAVES];    // Estado do que já foi gravado
+static journal_rec_t lote[JOURNAL_STAGING];
+static size_t num_lote;
+
+static uint32_t montagens, cortes, falhas, max_reexecutados;
+static double soma_montagem_us, max_montagem_us;
+
+
+static double agora_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void aplica(int32_t *estado, const journal_rec_t *r) {
+    if (r->kind == JOURNAL_DELTA)
+        estado[r->key] += r->value;
+    else
+        estado[r->key] = r->value;
+}
+
+static bool confere(const int32_t *estado) {
+    for (uint8_t k = 0; k < BENCH_CHAVES; k++)
+        if (journal_state(&journal, k) != estado[k]) return false;
+    return true;
+}
+
+// Reinicia como a placa faria depois de um boot
+static void monta(void) {
+    double inicio = agora_us();
+    if (!journal_init(&journal, &flash, BENCH_CHAVES)) {
+        printf("journal_init falhou\n");
+        exit(1);
+    }
+    double us = agora_us() - inicio;
+
+    montagens++;
+    soma_montagem_us += us;
+    if (us > max_montagem_us) max_montagem_us = us;
+    if (journal.stats.replayed > max_reexecutados) max_reexecutados = journal.stats.replayed;
+}
+
+// Após um corte, o estado restaurado tem que ser o de algum prefixo do lote
+static void confere_corte(void) {
+    int32_t estado[BENCH_CHAVES];
+
+    memcpy(estado, modelo, sizeof(estado));
+    for (size_t k = 0; k <= num_lote; k++) {
+        if (confere(estado)) {
+            memcpy(modelo, estado, sizeof(modelo));
+            return;
+        }
+        if (k < num_lote) aplica(estado, &lote[k]);
+    }
+    falhas++;
+    memcpy(modelo, estado, sizeof(modelo));
+    for (uint8_t k = 0; k < BENCH_CHAVES; k++) modelo[k] = journal_state(&journal, k);
+}
+
+static void commit(void) {
+    bool corta = rand() % BENCH_CHANCE_CORTE == 0;
+
+    if (corta) host_flash_cortar_energia((uint32_t)rand() % HOST_FLASH_PAGINA);
+    journal_commit(&journal);
+
+    // Cortes também podem pegar o apagamento antecipado
+    if (!corta && rand() % BENCH_CHANCE_CORTE == 0) {
+        corta = true;
+        host_flash_cortar_energia((uint32_t)rand() % HOST_FLASH_SETOR);
+    }
+    journal_prepare(&journal);
+
+    if (corta) {
+        cortes++;
+        host_flash_religar();
+        monta();
+        confere_corte();
+    } else {
+        for (size_t i = 0; i < num_lote; i++) aplica(modelo, &lote[i]);
+    }
+    num_lote = 0;
+}
+
+
+// Transbordos da área de preparo e commits que falham, sem cortes: nada
+// acrescentado pode faltar depois de montar de novo
+static void confere_transbordo_e_falhas(uint32_t rodadas) {
+    int32_t vivo[BENCH_CHAVES] = {0};
+    uint32_t descartados = 0, commits_falhos = 0, divergencias = 0;
+
+    host_flash_init(&flash, 4);
+    monta();
+    for (uint32_t i = 0; i < rodadas; i++) {
+        uint32_t n = 1 + (uint32_t)rand() % (2 * JOURNAL_STAGING);
+        for (uint32_t k = 0; k < n; k++) {
+            journal_rec_t r = { .kind = JOURNAL_DELTA, .key = (uint8_t)(rand() % BENCH_CHAVES),
+                                .value = rand() % 2 ? 1 : -1 };
+            if (rand() % 50 == 0) {
+                r.kind = JOURNAL_SET;
+                r.value = (int16_t)(rand() % 100);
+            }
+            if (!journal_append(&journal, r.kind, r.key, r.value, i)) descartados++;
+            aplica(vivo, &r);
+        }
+        if (rand() % 4 == 0) host_flash_falhar(1 + (uint32_t)rand() % 3);
+        while (journal_pending(&journal)) {
+            if (journal_commit(&journal) == 0) commits_falhos++;
+        }
+        journal_prepare(&journal);
+        if (i % 16 == 15) {
+            monta();
+            if (!confere(vivo)) divergencias++;
+        }
+    }
+    host_flash_falhar(0);
+    monta();
+    if (!confere(vivo)) divergencias++;
+
+    printf("transbordo:   %u rodadas, %u registros descartados, %u commits falhos, %u divergencias\n",
+           rodadas, descartados, commits_falhos, divergencias);
+    falhas += divergencias;
+    if (descartados == 0 || commits_falhos == 0) falhas++;     // O caso não exercitou o que devia
+}
+
+
+int main(int argc, char **argv) {
+    uint32_t eventos = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 200000;
+    uint32_t setores = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : 16;
+    unsigned semente = argc > 3 ? (unsigned)strtoul(argv[3], NULL, 10) : 1;
+    size_t alvo = 1;
+
+    srand(semente);
+    host_flash_init(&flash, setores);
+    monta();
+
+    for (uint32_t i = 0; i < eventos; i++) {
+        journal_rec_t r = { .key = (uint8_t)(rand() % BENCH_CHAVES), .timestamp = i };
+        int sorteio = rand() % 100;
+        if (sorteio < 2) {
+            r.kind = JOURNAL_SET;
+            r.value = 0;
+        } else {
+            r.kind = JOURNAL_DELTA;
+            r.value = sorteio < 51 ? 1 : -1;
+        }
+        journal_append(&journal, r.kind, r.key, r.value, r.timestamp);
+        lote[num_lote++] = r;
+
+        if (num_lote >= alvo) {
+            commit();
+            alvo = 1 + (size_t)rand() % JOURNAL_STAGING;
+        }
+
+        // Boot limpo de vez em quando: o estado tem que bater exatamente
+        if (i % 5000 == 4999 && num_lote == 0) {
+            monta();
+            if (!confere(modelo)) falhas++;
+        }
+    }
+    if (num_lote) commit();
+    monta();
+    if (!confere(modelo)) falhas++;
+
+    host_flash_stats_t fs;
+    host_flash_stats(&fs);
+    printf("=== bench_journal: %u eventos, %u setores de %u bytes ===\n", eventos, setores, HOST_FLASH_SETOR);
+    printf("montagens:    %u (%u apos corte de energia), %u divergencias\n", montagens, cortes, falhas);
+    printf("restauracao:  media %.1f us, max %.1f us, ate %u registros reexecutados (limite %u)\n",
+           soma_montagem_us / montagens, max_montagem_us, max_reexecutados,
+           HOST_FLASH_SETOR / (uint32_t)sizeof(journal_rec_t));
+    printf("flash:        %u gravacoes de pagina, %u apagamentos, %.1f s de flash simulada\n",
+           fs.gravacoes, fs.apagamentos, fs.tempo_us / 1e6);
+    printf("desgaste:     %u a %u apagamentos por setor, %u violacoes NOR\n",
+           fs.min_apagamentos, fs.max_apagamentos, fs.violacoes);
+    printf("registros/gravacao: %.2f\n", (double)eventos / fs.gravacoes);
+
+    confere_transbordo_e_falhas(eventos / 1000 + 64);
+    return falhas || fs.violacoes ? 1 : 0;
+}
@@ -0,0 +1,252 @@
+/*
+ *  Benchmark do status pela rede no host, pelo loopback.
+ *
+ *  Threads POSIX fazem papel de clientes e alternam GET HTTP e pedidos UDP
+ *  o mais rápido que conseguem, enquanto uma tarefa injeta entradas e
+ *  saídas pelo gpio_irq_handler. Cada resposta é conferida (status, tamanho
+ *  e versão que nunca volta) e, no fim, o snapshot tem de mostrar a
+ *  ocupação real. Mede pedidos/s, latência e quantas reconstruções o
+ *  snapshot precisou para atender todos eles.
+ *
+ *  Uso: bench_rede [duracao_s] [clientes]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "controle_vaga.h"
+#include "hal_host.h"
+
+#define BENCH_MAX_CLIENTES 16
+#define BENCH_RESPOSTA 2048
+#define BENCH_INTERVALO_MS 350          // Entre bordas da mesma pista (acima do debounce)
+#define BENCH_AMOSTRAS 65536
+
+typedef struct {
+    uint32_t http, udp, erros;
+    uint32_t amostras[BENCH_AMOSTRAS];  // Latência em us
+    uint32_t num_amostras;
+} bench_cliente_t;
+
+static uint32_t duracao_s = 10;
+static uint32_t num_clientes = 4;
+static bench_cliente_t clientes[BENCH_MAX_CLIENTES];
+static atomic_bool parar;
+
+
+void bench_trace_isr(uint gpio, bool aceito) {
+}
+
+void bench_trace_tarefa(uint gpio, uint32_t irq_us) {
+}
+
+
+static uint64_t agora_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static struct sockaddr_in endereco(uint16_t porta) {
+    return (struct sockaddr_in){
+        .sin_family = AF_INET,
+        .sin_port = htons(porta),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+}
+
+
+// Resposta HTTP inteira (o servidor fecha depois de enviar); tamanho ou -1
+static int pede_http(const char *pedido, char *resposta) {
+    struct sockaddr_in servidor = endereco(REDE_PORTA_HTTP);
+    int s = socket(AF_INET, SOCK_STREAM, 0);
+    int total = 0;
+    ssize_t n;
+
+    if (s < 0) return -1;
+    if (connect(s, (struct sockaddr *)&servidor, sizeof(servidor)) != 0 ||
+        send(s, pedido, strlen(pedido), MSG_NOSIGNAL) < 0) {
+        close(s);
+        return -1;
+    }
+    while ((n = recv(s, resposta + total, BENCH_RESPOSTA - 1 - total, 0)) > 0) {
+        total += n;
+    }
+    close(s);
+    resposta[total] = '\0';
+    return total;
+}
+
+// Corpo JSON em resposta; tamanho ou -1
+static int pede_udp(int s, char *resposta) {
+    struct sockaddr_in servidor = endereco(REDE_PORTA_UDP);
+
+    if (sendto(s, "?", 1, 0, (struct sockaddr *)&servidor, sizeof(servidor)) < 0) return -1;
+    ssize_t n = recv(s, resposta, BENCH_RESPOSTA - 1, 0);
+    if (n < 0) return -1;
+    resposta[n] = '\0';
+    return (int)n;
+}
+
+static long campo(const char *json, const char *nome) {
+    const char *p = json ? strstr(json, nome) : NULL;
+    return p ? strtol(p + strlen(nome), NULL, 10) : -1;
+}
+
+// Corpo de uma resposta 200 com o Content-Length certo, ou NULL
+static const char *corpo_http(const char *resposta, int n) {
+    const char *corpo = strstr(resposta, "\r\n\r\n");
+    if (n < 0 || strncmp(resposta, "HTTP/1.0 200", 12) != 0 || corpo == NULL) return NULL;
+    corpo += 4;
+    return campo(resposta, "Content-Length: ") == resposta + n - corpo ? corpo : NULL;
+}
+
+
+static void *cliente(void *arg) {
+    bench_cliente_t *c = arg;
+    static _Thread_local char resposta[BENCH_RESPOSTA];
+    struct timeval limite = { .tv_sec = 1 };
+    long versao = 0;
+    int s = socket(AF_INET, SOCK_DGRAM, 0);
+
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &limite, sizeof(limite));
+    for (uint32_t i = 0; !atomic_load(&parar); i++) {
+        uint64_t inicio = agora_us();
+        const char *json;
+
+        if (i & 1) {
+            json = pede_udp(s, resposta) > 0 ? resposta : NULL;
+            c->udp++;
+        } else {
+            json = corpo_http(resposta, pede_http("GET /status HTTP/1.0\r\n\r\n", resposta));
+            c->http++;
+        }
+        long v = campo(json, "\"versao\":");
+        if (json == NULL || v < versao || campo(json, "\"ocupadas\":") < 0) {
+            c->erros++;
+        } else {
+            versao = v;
+        }
+        if (c->num_amostras < BENCH_AMOSTRAS) {
+            c->amostras[c->num_amostras++] = (uint32_t)(agora_us() - inicio);
+        }
+    }
+    close(s);
+    return NULL;
+}
+
+
+static int compara_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void relatorio(uint64_t tempo_us) {
+    static uint32_t todas[BENCH_MAX_CLIENTES * BENCH_AMOSTRAS];
+    uint32_t n = 0, http = 0, udp = 0, erros = 0;
+    rede_stats_t rede;
+
+    for (uint32_t i = 0; i < num_clientes; i++) {
+        memcpy(&todas[n], clientes[i].amostras, clientes[i].num_amostras * sizeof(uint32_t));
+        n += clientes[i].num_amostras;
+        http += clientes[i].http;
+        udp += clientes[i].udp;
+        erros += clientes[i].erros;
+    }
+    qsort(todas, n, sizeof(todas[0]), compara_u32);
+    rede_stats(&rede);
+
+    printf("\n=== bench_rede: %.1f s, %u clientes ===\n", tempo_us / 1e6, num_clientes);
+    printf("pedidos:      %u http, %u udp, %u erros (%.0f pedidos/s)\n", http, udp, erros,
+           (http + udp) / (tempo_us / 1e6));
+    if (n) {
+        printf("latencia us:  p50 %u  p90 %u  p99 %u  max %u\n", todas[n / 2], todas[n * 9 / 10],
+               todas[n * 99 / 100], todas[n - 1]);
+    }
+    printf("servidor:     %u http, %u udp, %u nao encontrados\n", rede.http, rede.udp, rede.nao_encontrado);
+    printf("snapshot:     %u reconstrucoes (%.1f pedidos por reconstrucao)\n", rede.versao,
+           rede.versao ? (double)(rede.http + rede.udp) / rede.versao : 0.0);
+}
+
+
+// Entradas e saídas alternadas (duas entradas por saída até lotar e
+// encher a fila de admissão), depois a conferência final
+static void vTaskBenchRede(void *params) {
+    static pthread_t threads[BENCH_MAX_CLIENTES];
+    static char resposta[BENCH_RESPOSTA];
+    sigset_t todos, antigo;
+
+    // Deixa passar a janela de debounce inicial e a abertura das portas
+    vTaskDelay(pdMS_TO_TICKS(DEBOUNCE_TIME / 1000 + 100));
+
+    sigfillset(&todos);
+    pthread_sigmask(SIG_BLOCK, &todos, &antigo);
+    for (uint32_t i = 0; i < num_clientes; i++) {
+        pthread_create(&threads[i], NULL, cliente, &clientes[i]);
+    }
+    pthread_sigmask(SIG_SETMASK, &antigo, NULL);
+
+    uint64_t inicio = time_us_64();
+    uint64_t fim = inicio + (uint64_t)duracao_s * 1000000u;
+    TickType_t ultimo = xTaskGetTickCount();
+    for (uint32_t i = 0; time_us_64() < fim; i++) {
+        host_gpio_trigger(BUTTON_A, GPIO_IRQ_EDGE_FALL);
+        if (i % 2) {
+            host_gpio_trigger(BUTTON_B, GPIO_IRQ_EDGE_FALL);
+        }
+        vTaskDelayUntil(&ultimo, pdMS_TO_TICKS(BENCH_INTERVALO_MS));
+    }
+    atomic_store(&parar, true);
+    for (uint32_t i = 0; i < num_clientes; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    uint64_t tempo = time_us_64() - inicio;
+
+    // Sem eventos novos o snapshot tem de alcançar o estado real
+    vTaskDelay(pdMS_TO_TICKS(3 * REDE_LOTE_MS));
+    uint16_t capacidade;
+    long esperado = estacionamento_total(&capacidade);
+    long visto = campo(corpo_http(resposta, pede_http("GET / HTTP/1.0\r\n\r\n", resposta)), "\"ocupadas\":");
+    bool nao_encontrado = pede_http("GET /nada HTTP/1.0\r\n\r\n", resposta) > 0 &&
+                          strncmp(resposta, "HTTP/1.0 404", 12) == 0;
+
+    relatorio(tempo);
+    printf("final:        snapshot %ld ocupadas, estacionamento %ld; 404 %s\n", visto, esperado,
+           nao_encontrado ? "ok" : "falhou");
+
+    uint32_t erros = 0;
+    for (uint32_t i = 0; i < num_clientes; i++) erros += clientes[i].erros;
+    exit(visto == esperado && nao_encontrado && erros == 0 ? 0 : 1);
+}
+
+
+int main(int argc, char **argv) {
+    if (argc > 1) duracao_s = (uint32_t)strtoul(argv[1], NULL, 10);
+    if (argc > 2) num_clientes = (uint32_t)strtoul(argv[2], NULL, 10);
+    if (num_clientes == 0 || num_clientes > BENCH_MAX_CLIENTES) {
+        printf("Clientes: 1 a %u\n", BENCH_MAX_CLIENTES);
+        return 2;
+    }
+
+    stdio_init_all();
+    if (!controle_vaga_init()) {
+        return 1;
+    }
+    rede_init();
+
+    TaskHandle_t tarefa;
+    CRIA_TAREFA(tarefa, vTaskBenchRede, "BenchTask", configMINIMAL_STACK_SIZE * 4, configMAX_PRIORITIES - 2);
+    vTaskStartScheduler();
+    return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ *  Conferência e microbenchmark do mapa de vagas (lib/slot_bitmap.c).
+ *
+ *  Para 1, 1025 e 32768 vagas (uma palavra, um resumo com sobra e a raiz
+ *  cheia): ocupa todas em ordem até o mapa recusar, libera vagas
+ *  aleatórias e confere que cada alocação devolve a menor livre, contra um
+ *  vetor de referência. Depois mede o custo de alocar e liberar com o mapa
+ *  quase cheio.
+ *
+ *  Uso: bench_slot_bitmap [operacoes] [semente]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "lib/slot_bitmap.h"
+
+static uint32_t palavras[SLOT_BITMAP_WORDS(SLOT_BITMAP_MAX)];
+static uint32_t resumos[SLOT_BITMAP_SUMMARY(SLOT_BITMAP_MAX)];
+static bool ocupada[SLOT_BITMAP_MAX];
+static uint32_t falhas;
+
+
+static double agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void falha(uint32_t capacidade, const char *o_que, long obtido, long esperado) {
+    if (falhas++ < 10) {
+        printf("  %u vagas: %s %ld, esperado %ld\n", capacidade, o_que, obtido, esperado);
+    }
+}
+
+static int32_t menor_livre(uint32_t capacidade) {
+    for (uint32_t i = 0; i < capacidade; i++) {
+        if (!ocupada[i]) return (int32_t)i;
+    }
+    return SLOT_BITMAP_NONE;
+}
+
+
+static void confere(uint32_t capacidade, uint32_t operacoes) {
+    slot_bitmap_t bm;
+    uint32_t falhas_antes = falhas;
+
+    memset(ocupada, 0, sizeof(ocupada));
+    if (!slot_bitmap_init(&bm, palavras, resumos, capacidade)) {
+        falha(capacidade, "init", 0, 1);
+        return;
+    }
+
+    // Enche em ordem e confere a recusa com o mapa cheio
+    for (uint32_t i = 0; i < capacidade; i++) {
+        int32_t vaga = slot_bitmap_alloc(&bm);
+        if (vaga != (int32_t)i) falha(capacidade, "alocou", vaga, i);
+        if (vaga >= 0) ocupada[vaga] = true;
+    }
+    if (slot_bitmap_alloc(&bm) != SLOT_BITMAP_NONE) falha(capacidade, "cheio alocou", 0, SLOT_BITMAP_NONE);
+    if (bm.free != 0) falha(capacidade, "livres cheio", bm.free, 0);
+
+    // Liberações e alocações aleatórias contra a referência
+    for (uint32_t n = 0; n < operacoes; n++) {
+        uint32_t vaga = (uint32_t)rand() % capacidade;
+        if (rand() % 2) {
+            bool liberou = slot_bitmap_release(&bm, vaga);
+            if (liberou != ocupada[vaga]) falha(capacidade, "liberou", liberou, ocupada[vaga]);
+            ocupada[vaga] = false;
+        } else {
+            int32_t esperado = menor_livre(capacidade);
+            int32_t obtido = slot_bitmap_alloc(&bm);
+            if (obtido != esperado) falha(capacidade, "alocou", obtido, esperado);
+            if (obtido >= 0) ocupada[obtido] = true;
+        }
+    }
+    uint32_t livres = 0;
+    for (uint32_t i = 0; i < capacidade; i++) {
+        livres += !ocupada[i];
+        if (slot_bitmap_is_free(&bm, i) == ocupada[i]) falha(capacidade, "estado da vaga", i, !ocupada[i]);
+    }
+    if (bm.free != livres) falha(capacidade, "livres", bm.free, livres);
+
+    // Esvazia e confere que volta a aceitar tudo
+    slot_bitmap_clear(&bm);
+    if (bm.free != capacidade) falha(capacidade, "livres depois de limpar", bm.free, capacidade);
+    if (slot_bitmap_alloc(&bm) != 0) falha(capacidade, "primeira depois de limpar", 0, 0);
+
+    printf("%6u vagas: %s\n", capacidade, falhas == falhas_antes ? "ok" : "FALHOU");
+}
+
+
+// Alterna liberar uma vaga aleatória e alocar a menor livre, com o mapa cheio
+static void mede(uint32_t capacidade, uint32_t operacoes) {
+    slot_bitmap_t bm;
+
+    slot_bitmap_init(&bm, palavras, resumos, capacidade);
+    while (slot_bitmap_alloc(&bm) != SLOT_BITMAP_NONE) {
+    }
+    double inicio = agora_ns();
+    for (uint32_t n = 0; n < operacoes; n++) {
+        slot_bitmap_release(&bm, (uint32_t)rand() % capacidade);
+        slot_bitmap_alloc(&bm);
+    }
+    printf("%6u vagas: %.1f ns por liberar + alocar\n", capacidade, (agora_ns() - inicio) / operacoes);
+}
+
+
+int main(int argc, char **argv) {
+    static const uint32_t capacidades[] = { 1, 1025, SLOT_BITMAP_MAX };
+    uint32_t operacoes = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 20000;
+    unsigned semente = argc > 2 ? (unsigned)strtoul(argv[2], NULL, 10) : 1;
+
+    srand(semente);
+    printf("=== bench_slot_bitmap: %u operacoes ===\n", operacoes);
+    for (size_t i = 0; i < sizeof(capacidades) / sizeof(capacidades[0]); i++) {
+        confere(capacidades[i], operacoes);
+    }
+    for (size_t i = 0; i < sizeof(capacidades) / sizeof(capacidades[0]); i++) {
+        mede(capacidades[i], operacoes * 50);
+    }
+    return falhas ? 1 : 0;
+}
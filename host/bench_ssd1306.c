@@ -0,0 +1,182 @@
+/*
+ *  Microbenchmark das primitivas de desenho do SSD1306 no host.
+ *
+ *  Compara as versões por byte da lib/ssd1306.c com as versões originais
+ *  pixel a pixel (reproduzidas abaixo sobre ssd1306_pixel) e confere que
+ *  ambas produzem o mesmo ram_buffer. O caso "tela pronta" compara o texto
+ *  rasterizado em tempo de execução com a cópia da tela gerada no build.
+ *  Ao fim, conta as transações de barramento da configuração e de um frame
+ *  cheio pelo barramento contador do HAL.
+ *
+ *  Uso: bench_ssd1306 [iteracoes]
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hal_host.h"
+#include "lib/ssd1306.h"
+#include "lib/font.h"
+#include "telas.h"
+
+static ssd1306_t ref, rapido;
+
+
+// ---------------------------------------------------------------- Referência pixel a pixel
+
+static void ref_fill(ssd1306_t *ssd, bool value) {
+    for (uint8_t y = 0; y < ssd->height; ++y)
+        for (uint8_t x = 0; x < ssd->width; ++x)
+            ssd1306_pixel(ssd, x, y, value);
+}
+
+static void ref_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
+    for (uint8_t x = x0; x <= x1; ++x)
+        ssd1306_pixel(ssd, x, y, value);
+}
+
+static void ref_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
+    for (uint8_t y = y0; y <= y1; ++y)
+        ssd1306_pixel(ssd, x, y, value);
+}
+
+static void ref_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+    for (uint8_t x = left; x < left + width; ++x) {
+        ssd1306_pixel(ssd, x, top, value);
+        ssd1306_pixel(ssd, x, top + height - 1, value);
+    }
+    for (uint8_t y = top; y < top + height; ++y) {
+        ssd1306_pixel(ssd, left, y, value);
+        ssd1306_pixel(ssd, left + width - 1, y, value);
+    }
+    if (fill) {
+        for (uint8_t x = left + 1; x < left + width - 1; ++x)
+            for (uint8_t y = top + 1; y < top + height - 1; ++y)
+                ssd1306_pixel(ssd, x, y, value);
+    }
+}
+
+static void ref_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y) {
+    uint16_t index = (c >= ' ' && c <= '~') ? (c - ' ') * 8 : 0;
+    for (uint8_t i = 0; i < 8; ++i) {
+        uint8_t line = font[index + i];
+        for (uint8_t j = 0; j < 8; ++j)
+            ssd1306_pixel(ssd, x + i, y + j, line & (1 << j));
+    }
+}
+
+static void ref_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y) {
+    while (*str) {
+        ref_draw_char(ssd, *str++, x, y);
+        x += 8;
+        if (x + 8 >= ssd->width) {
+            x = 0;
+            y += 8;
+        }
+        if (y + 8 >= ssd->height)
+            break;
+    }
+}
+
+
+// ---------------------------------------------------------------- Casos
+
+typedef struct {
+    const char *nome;
+    void (*ref)(ssd1306_t *ssd, int i);
+    void (*rapido)(ssd1306_t *ssd, int i);
+} caso_t;
+
+static void ref_caso_fill(ssd1306_t *s, int i) { ref_fill(s, i & 1); }
+static void caso_fill(ssd1306_t *s, int i) { ssd1306_fill(s, i & 1); }
+static void ref_caso_hline(ssd1306_t *s, int i) { ref_hline(s, 3, 120, i % 64, !(i & 1)); }
+static void caso_hline(ssd1306_t *s, int i) { ssd1306_hline(s, 3, 120, i % 64, !(i & 1)); }
+static void ref_caso_vline(ssd1306_t *s, int i) { ref_vline(s, i % 128, 3, 60, !(i & 1)); }
+static void caso_vline(ssd1306_t *s, int i) { ssd1306_vline(s, i % 128, 3, 60, !(i & 1)); }
+static void ref_caso_rect(ssd1306_t *s, int i) { ref_rect(s, 5 + i % 7, 10, 100, 40, !(i & 1), true); }
+static void caso_rect(ssd1306_t *s, int i) { ssd1306_rect(s, 5 + i % 7, 10, 100, 40, !(i & 1), true); }
+static void ref_caso_borda(ssd1306_t *s, int i) { ref_rect(s, 5 + i % 7, 10, 100, 40, !(i & 1), false); }
+static void caso_borda(ssd1306_t *s, int i) { ssd1306_rect(s, 5 + i % 7, 10, 100, 40, !(i & 1), false); }
+static void ref_caso_texto8(ssd1306_t *s, int i) { ref_draw_string(s, (i & 1) ? "Eventos: 3" : "Aguardando", 5, 40); }
+static void caso_texto8(ssd1306_t *s, int i) { ssd1306_draw_string(s, (i & 1) ? "Eventos: 3" : "Aguardando", 5, 40); }
+static void ref_caso_texto(ssd1306_t *s, int i) { ref_draw_string(s, (i & 1) ? "Eventos: 3" : "Aguardando", 5, 44); }
+static void caso_texto(ssd1306_t *s, int i) { ssd1306_draw_string(s, (i & 1) ? "Eventos: 3" : "Aguardando", 5, 44); }
+static void ref_caso_tela(ssd1306_t *s, int i) {
+    ref_fill(s, 0);
+    if (i & 1) {
+        ref_draw_string(s, "Evento ", 5, 10);
+        ref_draw_string(s, "recebido!", 5, 19);
+        ref_draw_string(s, "Eventos:", 5, 44);
+    } else {
+        ref_draw_string(s, "Contador ", 5, 10);
+        ref_draw_string(s, "resetado!", 5, 19);
+    }
+}
+static void caso_tela(ssd1306_t *s, int i) { ssd1306_blit(s, (i & 1) ? tela_entrada : tela_reset); }
+
+static const caso_t casos[] = {
+    { "fill",           ref_caso_fill,  caso_fill },
+    { "hline",          ref_caso_hline, caso_hline },
+    { "vline",          ref_caso_vline, caso_vline },
+    { "rect cheio",     ref_caso_rect,  caso_rect },
+    { "rect borda",     ref_caso_borda, caso_borda },
+    { "texto y=40",     ref_caso_texto8, caso_texto8 },
+    { "texto y=44",     ref_caso_texto, caso_texto },
+    { "tela pronta",    ref_caso_tela,  caso_tela },
+};
+
+
+static double agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static double mede(void (*fn)(ssd1306_t *, int), ssd1306_t *ssd, int iteracoes) {
+    double inicio = agora_ns();
+    for (int i = 0; i < iteracoes; i++)
+        fn(ssd, i);
+    return (agora_ns() - inicio) / iteracoes;
+}
+
+
+int main(int argc, char **argv) {
+    int iteracoes = argc > 1 ? atoi(argv[1]) : 20000;
+    int falhas = 0;
+
+    ssd1306_init(&ref, WIDTH, HEIGHT, false, host_ssd1306_bus());
+    ssd1306_init(&rapido, WIDTH, HEIGHT, false, host_ssd1306_bus());
+
+    printf("%-12s %12s %12s %8s  %s\n", "primitiva", "pixel ns", "byte ns", "ganho", "resultado");
+    for (size_t c = 0; c < sizeof(casos) / sizeof(casos[0]); c++) {
+        // Mesmo estado inicial e mesma sequência nos dois buffers
+        memset(&ref.ram_buffer[1], 0x5A, ref.bufsize - 1);
+        memset(&rapido.ram_buffer[1], 0x5A, rapido.bufsize - 1);
+        double t_ref = mede(casos[c].ref, &ref, iteracoes);
+        double t_rapido = mede(casos[c].rapido, &rapido, iteracoes);
+        bool igual = memcmp(ref.ram_buffer, rapido.ram_buffer, ref.bufsize) == 0;
+        falhas += !igual;
+
+        printf("%-12s %12.1f %12.1f %7.1fx  %s\n", casos[c].nome, t_ref, t_rapido,
+               t_ref / t_rapido, igual ? "ok" : "DIVERGE");
+    }
+
+    // Transporte: a configuração e cada janela vão em poucas transações
+    host_ssd1306_bus_stats_t bus;
+    host_ssd1306_bus_stats_reset();
+    ssd1306_config(&rapido);
+    host_ssd1306_bus_stats(&bus);
+    printf("\nconfig:      %u transacoes, %llu bytes de comando\n", bus.transacoes,
+           (unsigned long long)bus.comandos);
+
+    host_ssd1306_bus_stats_reset();
+    ssd1306_invalidate(&rapido);
+    ssd1306_send_data(&rapido);
+    host_ssd1306_bus_stats(&bus);
+    bool painel = memcmp(host_ssd1306_gram(), &rapido.ram_buffer[1], rapido.bufsize - 1) == 0;
+    falhas += !painel;
+    printf("frame cheio: %u transacoes, %llu bytes de comando, %llu de dados  %s\n", bus.transacoes,
+           (unsigned long long)bus.comandos, (unsigned long long)bus.dados, painel ? "ok" : "DIVERGE");
+    return falhas ? 1 : 0;
+}
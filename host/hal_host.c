@@ -0,0 +1,480 @@
+/*
+ *  HAL simulado do Pico para executar o controle de vagas no Linux
+ *  sobre o port POSIX do FreeRTOS.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "hal_host.h"
+#include "hardware/gpio.h"
+#include "hardware/i2c.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+
+i2c_inst_t i2c0_inst;
+i2c_inst_t i2c1_inst;
+
+static uint32_t sys_khz = 125000;
+
+static struct {
+    bool out;
+    bool value;
+    bool pull_up;
+    enum gpio_function fn;
+    uint32_t irq_events;
+} gpios[NUM_BANK0_GPIOS];
+static gpio_irq_callback_t gpio_callback;
+
+static struct {
+    uint16_t level[2];
+    uint16_t wrap;
+    float clkdiv;
+    bool enabled;
+} pwm_slices[8];
+
+static bool i2c_simular = true;
+static host_i2c_stats_t i2c_stats;
+
+// Memória de vídeo do SSD1306 simulado, na ordem do endereçamento vertical
+static struct {
+    uint8_t gram[HOST_SSD1306_COLS * HOST_SSD1306_PAGES];
+    uint8_t cmd, args[2], nargs, esperados;
+    uint8_t col0, col1, pag0, pag1, col, pag;
+} oled = { .col1 = HOST_SSD1306_COLS - 1, .pag1 = HOST_SSD1306_PAGES - 1 };
+
+
+// ---------------------------------------------------------------- Tempo
+
+static uint64_t relogio_abs_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static uint64_t relogio_us(void) {
+    static uint64_t inicio;
+    uint64_t agora = relogio_abs_us();
+    if (inicio == 0) inicio = agora;
+    return agora - inicio;
+}
+
+absolute_time_t get_absolute_time(void) { return relogio_us(); }
+uint64_t time_us_64(void) { return relogio_us(); }
+uint32_t time_us_32(void) { return (uint32_t)relogio_us(); }
+
+// Com o escalonador rodando, sleep_* bloqueia só a tarefa (como o
+// configSUPPORT_PICO_TIME_INTEROP faz na placa)
+void sleep_us(uint64_t us) {
+    if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+        vTaskDelay(pdMS_TO_TICKS((us + 999u) / 1000u));
+    } else {
+        struct timespec ts = { .tv_sec = us / 1000000u, .tv_nsec = (us % 1000000u) * 1000u };
+        nanosleep(&ts, NULL);
+    }
+}
+
+void sleep_ms(uint32_t ms) { sleep_us((uint64_t)ms * 1000u); }
+
+// Espera ativa: a tarefa ocupa a CPU, como i2c_write_blocking na placa
+static void espera_ativa_us(uint64_t us) {
+    uint64_t fim = relogio_us() + us;
+    while (relogio_us() < fim) {
+        tight_loop_contents();
+    }
+}
+
+
+// ---------------------------------------------------------------- Alarmes
+
+#define HOST_MAX_ALARMES 16
+
+static struct {
+    alarm_id_t id;              // 0: livre
+    uint64_t quando;
+    alarm_callback_t callback;
+    void *dados;
+} alarmes[HOST_MAX_ALARMES];
+static alarm_id_t proximo_id = 1;
+static pthread_mutex_t alarmes_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t alarmes_cond = PTHREAD_COND_INITIALIZER;
+static bool alarmes_thread_ativa;
+
+// Thread que faz o papel da interrupção do timer
+static void *alarmes_thread(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&alarmes_mutex);
+    while (true) {
+        int prox = -1;
+        for (int i = 0; i < HOST_MAX_ALARMES; i++) {
+            if (alarmes[i].id && (prox < 0 || alarmes[i].quando < alarmes[prox].quando)) prox = i;
+        }
+        if (prox < 0) {
+            pthread_cond_wait(&alarmes_cond, &alarmes_mutex);
+            continue;
+        }
+
+        uint64_t agora = relogio_us();
+        if (alarmes[prox].quando > agora) {
+            uint64_t alvo = relogio_abs_us() + (alarmes[prox].quando - agora);
+            struct timespec ts = { .tv_sec = alvo / 1000000u, .tv_nsec = (alvo % 1000000u) * 1000u };
+            pthread_cond_timedwait(&alarmes_cond, &alarmes_mutex, &ts);
+            continue;
+        }
+
+        alarm_id_t id = alarmes[prox].id;
+        alarm_callback_t callback = alarmes[prox].callback;
+        void *dados = alarmes[prox].dados;
+        pthread_mutex_unlock(&alarmes_mutex);
+        int64_t novo = callback(id, dados);
+        pthread_mutex_lock(&alarmes_mutex);
+
+        // Reagenda como o SDK: >0 a partir do disparo anterior, <0 a partir de agora
+        if (alarmes[prox].id == id) {
+            if (novo > 0) {
+                alarmes[prox].quando += (uint64_t)novo;
+            } else if (novo < 0) {
+                alarmes[prox].quando = relogio_us() + (uint64_t)(-novo);
+            } else {
+                alarmes[prox].id = 0;
+            }
+        }
+    }
+    return NULL;
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    (void)fire_if_past;
+    alarm_id_t id = -1;
+
+    pthread_mutex_lock(&alarmes_mutex);
+    if (!alarmes_thread_ativa) {
+        pthread_t thread;
+        pthread_create(&thread, NULL, alarmes_thread, NULL);
+        pthread_detach(thread);
+        alarmes_thread_ativa = true;
+    }
+    for (int i = 0; i < HOST_MAX_ALARMES; i++) {
+        if (alarmes[i].id == 0) {
+            id = proximo_id++;
+            alarmes[i].id = id;
+            alarmes[i].quando = relogio_us() + us;
+            alarmes[i].callback = callback;
+            alarmes[i].dados = user_data;
+            pthread_cond_signal(&alarmes_cond);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&alarmes_mutex);
+    return id;
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    return add_alarm_in_us((uint64_t)ms * 1000u, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t alarm_id) {
+    bool cancelado = false;
+    pthread_mutex_lock(&alarmes_mutex);
+    for (int i = 0; i < HOST_MAX_ALARMES; i++) {
+        if (alarm_id > 0 && alarmes[i].id == alarm_id) {
+            alarmes[i].id = 0;
+            cancelado = true;
+        }
+    }
+    pthread_mutex_unlock(&alarmes_mutex);
+    return cancelado;
+}
+
+
+// ---------------------------------------------------------------- Sistema
+
+bool stdio_init_all(void) {
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    return true;
+}
+
+bool set_sys_clock_khz(uint32_t freq_khz, bool required) {
+    (void)required;
+    sys_khz = freq_khz;
+    return true;
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index) {
+    (void)clk_index;
+    return sys_khz * 1000u;
+}
+
+void panic_unsupported(void) {
+    fprintf(stderr, "panic: operação não suportada\n");
+    abort();
+}
+
+
+// ---------------------------------------------------------------- GPIO
+
+void gpio_init(uint gpio) {
+    gpios[gpio].out = false;
+    gpios[gpio].value = false;
+    gpios[gpio].fn = GPIO_FUNC_SIO;
+}
+
+void gpio_set_dir(uint gpio, bool out) { gpios[gpio].out = out; }
+void gpio_set_function(uint gpio, enum gpio_function fn) { gpios[gpio].fn = fn; }
+
+void gpio_pull_up(uint gpio) {
+    gpios[gpio].pull_up = true;
+    if (!gpios[gpio].out) gpios[gpio].value = true;
+}
+
+void gpio_put(uint gpio, bool value) { gpios[gpio].value = value; }
+bool gpio_get(uint gpio) { return gpios[gpio].value; }
+
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled) {
+    if (enabled)
+        gpios[gpio].irq_events |= events;
+    else
+        gpios[gpio].irq_events &= ~events;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback) {
+    gpio_set_irq_enabled(gpio, events, enabled);
+    if (enabled) gpio_callback = callback;
+}
+
+void host_gpio_trigger(uint gpio, uint32_t events) {
+    uint32_t ativos = events & gpios[gpio].irq_events;
+    if (ativos && gpio_callback) {
+        gpio_callback(gpio, ativos);
+    }
+}
+
+
+// ---------------------------------------------------------------- I2C
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+static uint8_t oled_num_args(uint8_t cmd) {
+    switch (cmd) {
+        case 0x21: case 0x22: return 2;
+        case 0x20: case 0x81: case 0xA8: case 0xD3: case 0xDA:
+        case 0xD5: case 0xD9: case 0xDB: case 0x8D: return 1;
+        default: return 0;
+    }
+}
+
+static void oled_comando(uint8_t byte) {
+    if (oled.esperados == 0) {
+        oled.cmd = byte;
+        oled.nargs = 0;
+        oled.esperados = oled_num_args(byte);
+        return;
+    }
+    oled.args[oled.nargs++] = byte;
+    if (oled.nargs < oled.esperados) return;
+    oled.esperados = 0;
+
+    if (oled.cmd == 0x21) {
+        oled.col0 = oled.col = oled.args[0] % HOST_SSD1306_COLS;
+        oled.col1 = oled.args[1] % HOST_SSD1306_COLS;
+    } else if (oled.cmd == 0x22) {
+        oled.pag0 = oled.pag = oled.args[0] % HOST_SSD1306_PAGES;
+        oled.pag1 = oled.args[1] % HOST_SSD1306_PAGES;
+    }
+}
+
+// Endereçamento vertical: avança a página e, ao fim da janela, a coluna
+static void oled_dado(uint8_t byte) {
+    oled.gram[oled.col * HOST_SSD1306_PAGES + oled.pag] = byte;
+    if (oled.pag++ == oled.pag1) {
+        oled.pag = oled.pag0;
+        oled.col = (oled.col == oled.col1) ? oled.col0 : oled.col + 1;
+    }
+}
+
+// Decodifica os bytes de controle: 0x80 (um comando), 0x00 (sequência de
+// comandos) e 0x40 (sequência de dados)
+static void oled_transacao(const uint8_t *src, size_t len) {
+    size_t i = 0;
+    while (i + 1 < len) {
+        uint8_t controle = src[i++];
+        if (controle & 0x40) {
+            while (i < len) oled_dado(src[i++]);
+        } else if (controle & 0x80) {
+            oled_comando(src[i++]);
+        } else {
+            while (i < len) oled_comando(src[i++]);
+        }
+    }
+}
+
+const uint8_t *host_ssd1306_gram(void) { return oled.gram; }
+
+static host_ssd1306_bus_stats_t bus_stats;
+
+static void bus_contador_send(void *ctx, const uint8_t *stream, const ssd1306_segment_t *segments, uint8_t count,
+                              void (*done)(void *arg, bool ok), void *arg) {
+    for (uint8_t s = 0; s < count; s++) {
+        const uint8_t *src = &stream[segments[s].offset];
+        bus_stats.transacoes++;
+        if (segments[s].data) {
+            bus_stats.dados += segments[s].len;
+            for (uint16_t i = 0; i < segments[s].len; i++) oled_dado(src[i]);
+        } else {
+            bus_stats.comandos += segments[s].len;
+            for (uint16_t i = 0; i < segments[s].len; i++) oled_comando(src[i]);
+        }
+    }
+    done(arg, true);
+}
+
+static const ssd1306_bus_t bus_contador = { .send = bus_contador_send };
+
+const ssd1306_bus_t *host_ssd1306_bus(void) { return &bus_contador; }
+void host_ssd1306_bus_stats(host_ssd1306_bus_stats_t *stats) { *stats = bus_stats; }
+void host_ssd1306_bus_stats_reset(void) { bus_stats = (host_ssd1306_bus_stats_t){0}; }
+
+// O custo de cada transação é o tempo de barramento: 9 bits por byte
+// (8 de dados + ACK) mais o byte de endereço.
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)nostop;
+    if (addr == HOST_SSD1306_ADDR) oled_transacao(src, len);
+    uint64_t tempo_us = ((uint64_t)(len + 1) * 9u * 1000000u) / (i2c->baudrate ? i2c->baudrate : 100000u);
+
+    i2c_stats.transacoes++;
+    i2c_stats.bytes += len;
+    i2c_stats.tempo_us += tempo_us;
+
+    if (i2c_simular) espera_ativa_us(tempo_us);
+    return (int)len;
+}
+
+void host_i2c_simular_barramento(bool simular) { i2c_simular = simular; }
+void host_i2c_stats(host_i2c_stats_t *stats) { *stats = i2c_stats; }
+void host_i2c_stats_reset(void) { i2c_stats = (host_i2c_stats_t){0}; }
+
+
+// ---------------------------------------------------------------- Flash
+
+#define FLASH_PAGINA_US 800         // Tempos típicos de uma flash QSPI de 2 MB
+#define FLASH_SETOR_US 45000
+
+static struct {
+    uint8_t mem[HOST_FLASH_MAX_SETORES * HOST_FLASH_SETOR];
+    uint32_t setores;
+    uint32_t apagamentos[HOST_FLASH_MAX_SETORES];
+    bool simular;
+    bool cortar, sem_energia;
+    uint32_t cortar_bytes;
+    uint32_t falhas;
+    host_flash_stats_t stats;
+} flash_sim;
+
+static void flash_ler(void *ctx, uint32_t offset, void *buf, size_t len) {
+    memcpy(buf, &flash_sim.mem[offset], len);
+}
+
+// Quantos bytes a operação chega a escrever antes de um corte de energia
+static uint32_t flash_limite(uint32_t len) {
+    if (!flash_sim.cortar) return len;
+    flash_sim.cortar = false;
+    flash_sim.sem_energia = true;
+    return flash_sim.cortar_bytes < len ? flash_sim.cortar_bytes : len;
+}
+
+// Falha injetada por host_flash_falhar: a operação nem começa
+static bool flash_falha(void) {
+    if (flash_sim.falhas == 0) return false;
+    flash_sim.falhas--;
+    return true;
+}
+
+static bool flash_gravar(void *ctx, uint32_t offset, const uint8_t *pagina) {
+    if (flash_sim.sem_energia || flash_falha()) return false;
+
+    uint32_t n = flash_limite(HOST_FLASH_PAGINA);
+    for (uint32_t i = 0; i < n; i++) {
+        if (pagina[i] & ~flash_sim.mem[offset + i]) flash_sim.stats.violacoes++;
+        flash_sim.mem[offset + i] &= pagina[i];
+    }
+    flash_sim.stats.gravacoes++;
+    flash_sim.stats.tempo_us += FLASH_PAGINA_US;
+    if (flash_sim.simular) espera_ativa_us(FLASH_PAGINA_US);
+    return !flash_sim.sem_energia;
+}
+
+static bool flash_apagar(void *ctx, uint32_t offset) {
+    if (flash_sim.sem_energia || flash_falha()) return false;
+
+    uint32_t n = flash_limite(HOST_FLASH_SETOR);
+    memset(&flash_sim.mem[offset], 0xFF, n);
+    flash_sim.apagamentos[offset / HOST_FLASH_SETOR]++;
+    flash_sim.stats.apagamentos++;
+    flash_sim.stats.tempo_us += FLASH_SETOR_US;
+    if (flash_sim.simular) espera_ativa_us(FLASH_SETOR_US);
+    return !flash_sim.sem_energia;
+}
+
+void host_flash_init(journal_flash_t *flash, uint32_t setores) {
+    if (setores > HOST_FLASH_MAX_SETORES) setores = HOST_FLASH_MAX_SETORES;
+    memset(flash_sim.mem, 0xFF, sizeof(flash_sim.mem));
+    memset(flash_sim.apagamentos, 0, sizeof(flash_sim.apagamentos));
+    flash_sim.setores = setores;
+    flash_sim.cortar = flash_sim.sem_energia = false;
+    flash_sim.falhas = 0;
+    flash_sim.stats = (host_flash_stats_t){0};
+
+    flash->sector_size = HOST_FLASH_SETOR;
+    flash->page_size = HOST_FLASH_PAGINA;
+    flash->num_sectors = setores;
+    flash->read = flash_ler;
+    flash->program = flash_gravar;
+    flash->erase = flash_apagar;
+    flash->ctx = NULL;
+}
+
+// O journal do firmware usa a flash simulada no lugar da região reservada
+void journal_flash_rp2040(journal_flash_t *flash, uint32_t offset, uint32_t num_sectors) {
+    host_flash_init(flash, num_sectors);
+}
+
+void host_flash_simular_tempo(bool simular) { flash_sim.simular = simular; }
+
+void host_flash_cortar_energia(uint32_t bytes) {
+    flash_sim.cortar = true;
+    flash_sim.cortar_bytes = bytes;
+}
+
+void host_flash_religar(void) {
+    flash_sim.cortar = flash_sim.sem_energia = false;
+}
+
+void host_flash_falhar(uint32_t operacoes) { flash_sim.falhas = operacoes; }
+
+void host_flash_stats(host_flash_stats_t *stats) {
+    *stats = flash_sim.stats;
+    stats->min_apagamentos = UINT32_MAX;
+    stats->max_apagamentos = 0;
+    for (uint32_t s = 0; s < flash_sim.setores; s++) {
+        if (flash_sim.apagamentos[s] < stats->min_apagamentos) stats->min_apagamentos = flash_sim.apagamentos[s];
+        if (flash_sim.apagamentos[s] > stats->max_apagamentos) stats->max_apagamentos = flash_sim.apagamentos[s];
+    }
+}
+
+
+// ---------------------------------------------------------------- PWM
+
+void pwm_set_clkdiv(uint slice_num, float divider) { pwm_slices[slice_num].clkdiv = divider; }
+void pwm_set_wrap(uint slice_num, uint16_t wrap) { pwm_slices[slice_num].wrap = wrap; }
+void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level) { pwm_slices[slice_num].level[chan] = level; }
+void pwm_set_enabled(uint slice_num, bool enabled) { pwm_slices[slice_num].enabled = enabled; }
@@ -0,0 +1,71 @@
+#ifndef HAL_HOST_H
+#define HAL_HOST_H
+
+// Controles do HAL simulado que só existem no build do host
+
+#include "pico/stdlib.h"
+#include "lib/journal.h"
+#include "lib/ssd1306.h"
+
+typedef struct {
+    uint32_t transacoes;    // Chamadas a i2c_write_blocking
+    uint64_t bytes;         // Bytes transferidos (sem contar o endereço)
+    uint64_t tempo_us;      // Tempo de barramento simulado
+} host_i2c_stats_t;
+
+#define HOST_SSD1306_ADDR 0x3C
+#define HOST_SSD1306_COLS 128
+#define HOST_SSD1306_PAGES 8
+
+// Dispara o callback de interrupção registrado para o pino, como faria o hardware
+void host_gpio_trigger(uint gpio, uint32_t events);
+
+// Liga/desliga a espera ativa que imita o tempo de transferência no barramento I2C
+void host_i2c_simular_barramento(bool simular);
+void host_i2c_stats(host_i2c_stats_t *stats);
+void host_i2c_stats_reset(void);
+
+// Barramento do SSD1306 sem I2C (benchmarks do driver): conta transações e
+// bytes e entrega tudo direto ao painel simulado, sem tempo de barramento
+typedef struct {
+    uint32_t transacoes;    // Trechos enviados (cada um seria uma transação)
+    uint64_t comandos;      // Bytes de comando
+    uint64_t dados;         // Bytes de dados
+} host_ssd1306_bus_stats_t;
+
+const ssd1306_bus_t *host_ssd1306_bus(void);
+void host_ssd1306_bus_stats(host_ssd1306_bus_stats_t *stats);
+void host_ssd1306_bus_stats_reset(void);
+
+// Conteúdo atual do painel simulado (coluna * HOST_SSD1306_PAGES + página),
+// mesma ordem do ram_buffer do driver sem o byte de controle
+const uint8_t *host_ssd1306_gram(void);
+
+// Flash NOR simulada para o journal: gravar só leva bits de 1 para 0 e
+// apagar devolve o setor a 0xFF
+#define HOST_FLASH_SETOR 4096
+#define HOST_FLASH_PAGINA 256
+#define HOST_FLASH_MAX_SETORES 64
+
+typedef struct {
+    uint32_t gravacoes;
+    uint32_t apagamentos;
+    uint32_t violacoes;     // Gravações que tentaram levar um bit de 0 para 1
+    uint32_t min_apagamentos, max_apagamentos;  // Por setor (desgaste)
+    uint64_t tempo_us;      // Tempo simulado de gravação e apagamento
+} host_flash_stats_t;
+
+// Preenche 'flash' com uma região nova (toda apagada) de 'setores' setores
+void host_flash_init(journal_flash_t *flash, uint32_t setores);
+// Liga/desliga a espera ativa que imita o tempo de gravação e apagamento
+void host_flash_simular_tempo(bool simular);
+// A próxima gravação/apagamento para depois de 'bytes' bytes e todas as
+// operações falham até host_flash_religar
+void host_flash_cortar_energia(uint32_t bytes);
+void host_flash_religar(void);
+// As próximas 'operacoes' gravações/apagamentos falham sem tocar na flash,
+// como um flash_safe_execute que não conseguiu pausar o outro núcleo
+void host_flash_falhar(uint32_t operacoes);
+void host_flash_stats(host_flash_stats_t *stats);
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef HOST_TRACE_H
+#define HOST_TRACE_H
+
+// Liga os ganchos TRACE_EVENTO_* do controle_vaga.c ao benchmark do host
+
+#include "pico/stdlib.h"
+
+void bench_trace_isr(uint gpio, bool aceito);
+void bench_trace_tarefa(uint gpio, uint32_t irq_us);
+
+#define TRACE_EVENTO_ISR(gpio, aceito) bench_trace_isr((gpio), (aceito))
+#define TRACE_EVENTO_TAREFA(gpio, irq_us) bench_trace_tarefa((gpio), (irq_us))
+
+#endif
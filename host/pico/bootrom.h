@@ -0,0 +1,6 @@
+#ifndef HOST_PICO_BOOTROM_H
+#define HOST_PICO_BOOTROM_H
+
+#include "pico/stdlib.h"
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef HOST_PICO_CRITICAL_SECTION_H
+#define HOST_PICO_CRITICAL_SECTION_H
+
+#include <pthread.h>
+
+typedef struct {
+    pthread_mutex_t mutex;
+} critical_section_t;
+
+static inline void critical_section_init(critical_section_t *crit_sec) {
+    pthread_mutex_init(&crit_sec->mutex, NULL);
+}
+
+static inline void critical_section_enter_blocking(critical_section_t *crit_sec) {
+    pthread_mutex_lock(&crit_sec->mutex);
+}
+
+static inline void critical_section_exit(critical_section_t *crit_sec) {
+    pthread_mutex_unlock(&crit_sec->mutex);
+}
+
+#endif
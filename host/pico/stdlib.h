@@ -0,0 +1,35 @@
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+// Substituto mínimo do pico/stdlib.h para o build do host (Linux)
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define PICO_ON_DEVICE 0
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+// Tempo (microssegundos desde o início do processo)
+absolute_time_t get_absolute_time(void);
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+void sleep_ms(uint32_t ms);
+void sleep_us(uint64_t us);
+static inline void tight_loop_contents(void) {}
+
+bool stdio_init_all(void);
+bool set_sys_clock_khz(uint32_t freq_khz, bool required);
+void panic_unsupported(void);
+
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+#endif
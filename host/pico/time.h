@@ -0,0 +1,35 @@
+#ifndef HOST_PICO_TIME_H
+#define HOST_PICO_TIME_H
+
+// Alarmes do pico/time.h; no host os callbacks rodam numa thread própria,
+// fora do FreeRTOS, como uma interrupção de timer
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past);
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past);
+bool cancel_alarm(alarm_id_t alarm_id);
+
+// Um único pool (a thread de alarmes) atende todos os pedidos
+typedef struct alarm_pool alarm_pool_t;
+
+static inline alarm_pool_t *alarm_pool_get_default(void) { return (alarm_pool_t *)0; }
+static inline alarm_pool_t *alarm_pool_create_with_unused_hardware_alarm(unsigned max_timers) {
+    (void)max_timers;
+    return (alarm_pool_t *)0;
+}
+static inline alarm_id_t alarm_pool_add_alarm_in_us(alarm_pool_t *pool, uint64_t us, alarm_callback_t callback,
+                                                    void *user_data, bool fire_if_past) {
+    (void)pool;
+    return add_alarm_in_us(us, callback, user_data, fire_if_past);
+}
+static inline bool alarm_pool_cancel_alarm(alarm_pool_t *pool, alarm_id_t alarm_id) {
+    (void)pool;
+    return cancel_alarm(alarm_id);
+}
+
+#endif
@@ -0,0 +1,138 @@
+/*
+ *  Transporte do status no host: sockets BSD no loopback.
+ *
+ *  Uma thread POSIX fora do FreeRTOS espera com poll() na porta TCP e na
+ *  UDP e responde cada pedido segurando um mutex, que faz o papel da trava
+ *  do núcleo do lwIP na placa. A thread bloqueia todos os sinais para que
+ *  o tick do port POSIX nunca seja entregue a ela.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "controle_vaga.h"
+
+#define REDE_PEDIDO 32
+#define REDE_TIMEOUT_PEDIDO_MS 1000
+
+static pthread_mutex_t trava = PTHREAD_MUTEX_INITIALIZER;
+static int sock_http = -1;
+static int sock_udp = -1;
+
+
+void rede_trava(void) {
+    pthread_mutex_lock(&trava);
+}
+
+void rede_destrava(void) {
+    pthread_mutex_unlock(&trava);
+}
+
+
+static int abre_socket(int tipo, uint16_t porta) {
+    struct sockaddr_in endereco = {
+        .sin_family = AF_INET,
+        .sin_port = htons(porta),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    int um = 1;
+    int s = socket(AF_INET, tipo, 0);
+
+    if (s < 0) return -1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &um, sizeof(um));
+    if (bind(s, (struct sockaddr *)&endereco, sizeof(endereco)) != 0 ||
+        (tipo == SOCK_STREAM && listen(s, 16) != 0)) {
+        close(s);
+        return -1;
+    }
+    return s;
+}
+
+
+// Lê o começo do pedido e responde com um só send, como o tcp_write da placa
+static void atende_http(void) {
+    char pedido[REDE_PEDIDO];
+    size_t tamanho;
+    int c = accept(sock_http, NULL, NULL);
+
+    if (c < 0) return;
+    struct pollfd pronto = { .fd = c, .events = POLLIN };
+    ssize_t n = poll(&pronto, 1, REDE_TIMEOUT_PEDIDO_MS) == 1 ? recv(c, pedido, sizeof(pedido), 0) : -1;
+    if (n > 0) {
+        rede_trava();
+        const char *resposta = rede_resposta_http(pedido, (size_t)n, &tamanho);
+        send(c, resposta, tamanho, MSG_NOSIGNAL);
+        rede_destrava();
+    }
+    close(c);
+}
+
+
+static void atende_udp(void) {
+    char pedido[REDE_PEDIDO];
+    struct sockaddr_in origem;
+    socklen_t tam_origem = sizeof(origem);
+    size_t tamanho;
+
+    if (recvfrom(sock_udp, pedido, sizeof(pedido), 0, (struct sockaddr *)&origem, &tam_origem) < 0) {
+        return;
+    }
+    rede_trava();
+    const char *corpo = rede_resposta_udp(&tamanho);
+    sendto(sock_udp, corpo, tamanho, 0, (struct sockaddr *)&origem, tam_origem);
+    rede_destrava();
+}
+
+
+static void *rede_thread(void *arg) {
+    struct pollfd fds[2] = {
+        { .fd = sock_http, .events = POLLIN },
+        { .fd = sock_udp, .events = POLLIN },
+    };
+    while (true) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[0].revents & POLLIN) atende_http();
+        if (fds[1].revents & POLLIN) atende_udp();
+    }
+    return NULL;
+}
+
+
+bool rede_transporte_inicia(void) {
+    pthread_t thread;
+    sigset_t todos, antigo;
+
+    sock_http = abre_socket(SOCK_STREAM, REDE_PORTA_HTTP);
+    sock_udp = abre_socket(SOCK_DGRAM, REDE_PORTA_UDP);
+    if (sock_http < 0 || sock_udp < 0) {
+        printf("Portas do status indisponíveis (%u/%u): %s\n", REDE_PORTA_HTTP, REDE_PORTA_UDP,
+               strerror(errno));
+        if (sock_http >= 0) close(sock_http);
+        if (sock_udp >= 0) close(sock_udp);
+        return false;
+    }
+
+    // A thread herda a máscara: sinais bloqueados desde o primeiro instante
+    sigfillset(&todos);
+    pthread_sigmask(SIG_BLOCK, &todos, &antigo);
+    bool criada = pthread_create(&thread, NULL, rede_thread, NULL) == 0;
+    pthread_sigmask(SIG_SETMASK, &antigo, NULL);
+    if (!criada) {
+        return false;
+    }
+    pthread_detach(thread);
+    printf("Status em http://127.0.0.1:%u/status e udp %u\n", REDE_PORTA_HTTP, REDE_PORTA_UDP);
+    return true;
+}
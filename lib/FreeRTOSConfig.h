@@ -41,9 +41,18 @@
   *----------------------------------------------------------*/
  
  /* Scheduler Related */
+ #ifndef CONTROLE_VAGA_BAIXO_CONSUMO
+ #define CONTROLE_VAGA_BAIXO_CONSUMO             0
+ #endif
  #define configUSE_PREEMPTION                    1
+ #if CONTROLE_VAGA_BAIXO_CONSUMO
+ /* Tick parado com as tarefas bloqueadas; o gancho de idle decide o dormant */
+ #define configUSE_TICKLESS_IDLE                 1
+ #define configUSE_IDLE_HOOK                     1
+ #else
  #define configUSE_TICKLESS_IDLE                 0
  #define configUSE_IDLE_HOOK                     0
+ #endif
  #define configUSE_TICK_HOOK                     0
  #define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
  #define configMAX_PRIORITIES                    32
@@ -69,20 +78,58 @@
  #define configMESSAGE_BUFFER_LENGTH_TYPE        size_t
  
  /* Memory allocation related definitions. */
+ #ifndef CONTROLE_VAGA_ESTATICO
+ #define CONTROLE_VAGA_ESTATICO                  0
+ #endif
+ #ifndef CONTROLE_VAGA_REDE
+ #define CONTROLE_VAGA_REDE                      0
+ #endif
+ #if CONTROLE_VAGA_REDE && CONTROLE_VAGA_ESTATICO
+ #error "A thread e as mailboxes do lwIP são criadas no heap do FreeRTOS"
+ #endif
+ #if CONTROLE_VAGA_REDE && CONTROLE_VAGA_BAIXO_CONSUMO
+ #error "O dormant desliga o clock que o Wi-Fi usa"
+ #endif
+ #if CONTROLE_VAGA_ESTATICO
+ /* Tarefas, filas e timers em memória estática; idle e timers do kernel
+    vêm do FreeRTOS-Kernel-Static. Sem heap_4 no link */
+ #define configSUPPORT_STATIC_ALLOCATION         1
+ #define configSUPPORT_DYNAMIC_ALLOCATION        0
+ #else
  #define configSUPPORT_STATIC_ALLOCATION         0
  #define configSUPPORT_DYNAMIC_ALLOCATION        1
+ #endif
  #define configTOTAL_HEAP_SIZE                   (128*1024)
  #define configAPPLICATION_ALLOCATED_HEAP        0
  
  /* Hook function related definitions. */
+ #if CONTROLE_VAGA_ESTATICO
+ /* Pilhas enxutas: confere a marca no fim de cada pilha a cada troca */
+ #define configCHECK_FOR_STACK_OVERFLOW          2
+ #else
  #define configCHECK_FOR_STACK_OVERFLOW          0
+ #endif
  #define configUSE_MALLOC_FAILED_HOOK            0
  #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
  
  /* Run time and task stats gathering related definitions. */
+ #ifndef CONTROLE_VAGA_METRICAS
+ #define CONTROLE_VAGA_METRICAS                  0
+ #endif
+ #if CONTROLE_VAGA_METRICAS
+ /* Contador de run-time = timer de 1 MHz do RP2040 (já roda desde o boot) */
+ #define configGENERATE_RUN_TIME_STATS           1
+ #define configUSE_STATS_FORMATTING_FUNCTIONS    1
+ #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+ #ifndef __ASSEMBLER__
+ #include "hardware/timer.h"
+ #endif
+ #define portGET_RUN_TIME_COUNTER_VALUE()        time_us_32()
+ #else
  #define configGENERATE_RUN_TIME_STATS           0
- #define configUSE_TRACE_FACILITY                1
  #define configUSE_STATS_FORMATTING_FUNCTIONS    0
+ #endif
+ #define configUSE_TRACE_FACILITY                1
  
  /* Co-routine related definitions. */
  #define configUSE_CO_ROUTINES                   0
@@ -102,7 +149,20 @@
  */
  
  /* SMP port only */
+ #ifndef CONTROLE_VAGA_SMP
+ #define CONTROLE_VAGA_SMP                       0
+ #endif
+ #if CONTROLE_VAGA_SMP
+ #if CONTROLE_VAGA_BAIXO_CONSUMO
+ #error "O modo de baixo consumo (tickless/dormant) exige um só núcleo"
+ #endif
+ #define configNUM_CORES                         2
+ #define configNUMBER_OF_CORES                   configNUM_CORES
+ #define configUSE_CORE_AFFINITY                 1
+ #define configUSE_PASSIVE_IDLE_HOOK             0
+ #else
  #define configNUM_CORES                         1
+ #endif
  #define configTICK_CORE                         1
  #define configRUN_MULTIPLE_PRIORITIES           1
  
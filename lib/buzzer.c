@@ -1,6 +1,22 @@
-
 #include "buzzer.h"
 
+// Sequenciador: o padrão atual avança por um alarme de hardware, então quem
+// chama buzzer_submit retorna na hora. Só há um buzzer (o do último
+// buzzer_setup_pwm).
+static struct {
+    uint slice, channel;
+    critical_section_t lock;
+    buzzer_pattern_t queue[BUZZER_QUEUE_LEN];
+    uint8_t head, count;
+    buzzer_pattern_t current;
+    bool playing, on;
+    uint8_t tone, repeat;
+    alarm_pool_t *pool;         // Define em que núcleo os passos rodam
+    alarm_id_t alarm;
+    uint32_t generation;        // Invalida alarmes de um padrão já interrompido
+    buzzer_stats_t stats;
+} engine;
+
 
 void buzzer_setup_pwm(uint pin, uint freq_hz){
     gpio_set_function(pin, GPIO_FUNC_PWM);
@@ -12,12 +28,27 @@ void buzzer_setup_pwm(uint pin, uint freq_hz){
 
     pwm_set_chan_level(slice_num, channel, 0);
     pwm_set_enabled(slice_num, false);
+
+    engine.slice = slice_num;
+    engine.channel = channel;
+    engine.pool = alarm_pool_get_default();
+    critical_section_init(&engine.lock);
+}
+
+
+// Os callbacks de um pool rodam no núcleo que o criou
+void buzzer_set_alarm_pool(alarm_pool_t *pool) {
+    critical_section_enter_blocking(&engine.lock);
+    engine.pool = pool;
+    critical_section_exit(&engine.lock);
 }
 
 
+// Versão bloqueante (ocupa quem chama durante todo o padrão)
 void buzzer_play(uint pin, uint times, uint freq_hz, uint duration_ms) {
     uint slice_num = pwm_gpio_to_slice_num(pin); // Obtém o slice
     uint channel = pwm_gpio_to_channel(pin);     // Obtém o canal PWM
+    uint64_t start = time_us_64();
 
     for (int i = 0; i < times; i++) {
         pwm_set_chan_level(slice_num, channel, freq_hz/2); // Duty cycle 50% (som ligado)
@@ -27,4 +58,151 @@ void buzzer_play(uint pin, uint times, uint freq_hz, uint duration_ms) {
         pwm_set_enabled(slice_num, false);
         sleep_ms(duration_ms); // Pausa entre os toques
     }
+
+    critical_section_enter_blocking(&engine.lock);
+    engine.stats.blocking_us += time_us_64() - start;
+    critical_section_exit(&engine.lock);
+}
+
+
+// Mesmo nível de PWM do buzzer_play para o mesmo som
+static void buzzer_output(uint16_t freq_hz) {
+    pwm_set_chan_level(engine.slice, engine.channel, freq_hz / 2);
+    pwm_set_enabled(engine.slice, freq_hz != 0);
+}
+
+static bool buzzer_load_next(void) {
+    if (engine.count == 0) {
+        engine.playing = false;
+        return false;
+    }
+    engine.current = engine.queue[engine.head];
+    engine.head = (engine.head + 1) % BUZZER_QUEUE_LEN;
+    engine.count--;
+    engine.tone = 0;
+    engine.repeat = 0;
+    engine.playing = true;
+    return true;
+}
+
+// Avança a sequência um passo (com o lock). Retorna em quantos us vem o
+// próximo passo, ou 0 quando não há mais nada para tocar.
+static int64_t buzzer_advance(void) {
+    if (engine.on) {
+        // Fim de um tom: desliga e, se houver, cumpre a pausa
+        const buzzer_tone_t *t = &engine.current.tones[engine.tone];
+        buzzer_output(0);
+        engine.on = false;
+        if (++engine.tone == engine.current.count) {
+            engine.tone = 0;
+            engine.repeat++;
+        }
+        if (t->off_ms)
+            return (int64_t)t->off_ms * 1000;
+    }
+
+    if (engine.repeat >= engine.current.repeats) {
+        engine.stats.played++;
+        if (!buzzer_load_next())
+            return 0;
+    }
+
+    const buzzer_tone_t *t = &engine.current.tones[engine.tone];
+    buzzer_output(t->freq_hz);
+    engine.on = true;
+    return t->on_ms ? (int64_t)t->on_ms * 1000 : 1000;
+}
+
+static int64_t buzzer_alarm_cb(alarm_id_t id, void *user_data) {
+    uint32_t start = time_us_32();
+    int64_t next = 0;
+
+    critical_section_enter_blocking(&engine.lock);
+    if ((uint32_t)(uintptr_t)user_data == engine.generation) {
+        next = buzzer_advance();
+        if (next == 0)
+            engine.alarm = 0;
+    }
+    uint32_t us = time_us_32() - start;
+    engine.stats.callback_us += us;
+    if (us > engine.stats.callback_max_us)
+        engine.stats.callback_max_us = us;
+    critical_section_exit(&engine.lock);
+    return next;
+}
+
+// Começa 'pattern' agora, descartando o alarme do que estava tocando.
+// Retorna false se o pool não tem alarme livre: o padrão é descartado e o
+// buzzer fica parado, senão buzzer_busy nunca voltaria a false.
+static bool buzzer_start(const buzzer_pattern_t *pattern) {
+    if (engine.alarm > 0)
+        alarm_pool_cancel_alarm(engine.pool, engine.alarm);
+    engine.generation++;
+
+    engine.current = *pattern;
+    engine.tone = 0;
+    engine.repeat = 0;
+    engine.playing = true;
+    engine.on = false;
+
+    int64_t delay = buzzer_advance();
+    engine.alarm = alarm_pool_add_alarm_in_us(engine.pool, delay, buzzer_alarm_cb,
+                                              (void *)(uintptr_t)engine.generation, true);
+    if (engine.alarm < 0) {
+        buzzer_output(0);
+        engine.on = false;
+        engine.playing = false;
+        engine.alarm = 0;
+        engine.stats.dropped++;
+        return false;
+    }
+    return true;
+}
+
+
+// Enfileira um padrão sem bloquear. Um padrão de prioridade maior interrompe
+// o atual e tira da fila os de prioridade menor que a dele; os demais
+// esperam a vez. Retorna false se o padrão foi descartado (fila cheia ou
+// sem alarme livre).
+bool buzzer_submit(const buzzer_pattern_t *pattern) {
+    bool accepted = true;
+
+    if (pattern->count == 0 || pattern->repeats == 0)
+        return false;
+
+    critical_section_enter_blocking(&engine.lock);
+    if (!engine.playing) {
+        accepted = buzzer_start(pattern);
+    } else if (pattern->priority > engine.current.priority) {
+        uint8_t kept = 0;
+        for (uint8_t i = 0; i < engine.count; ++i) {
+            buzzer_pattern_t *p = &engine.queue[(engine.head + i) % BUZZER_QUEUE_LEN];
+            if (p->priority >= pattern->priority)
+                engine.queue[(engine.head + kept++) % BUZZER_QUEUE_LEN] = *p;
+            else
+                engine.stats.preempted++;
+        }
+        engine.count = kept;
+        engine.stats.preempted++;
+        buzzer_output(0);
+        accepted = buzzer_start(pattern);
+    } else if (engine.count < BUZZER_QUEUE_LEN) {
+        engine.queue[(engine.head + engine.count) % BUZZER_QUEUE_LEN] = *pattern;
+        engine.count++;
+    } else {
+        engine.stats.dropped++;
+        accepted = false;
+    }
+    critical_section_exit(&engine.lock);
+    return accepted;
+}
+
+bool buzzer_busy(void) {
+    return engine.playing;
+}
+
+void buzzer_get_stats(buzzer_stats_t *stats) {
+    critical_section_enter_blocking(&engine.lock);
+    *stats = engine.stats;
+    critical_section_exit(&engine.lock);
 }
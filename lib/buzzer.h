@@ -3,6 +3,7 @@
 
 #include <stdio.h>
 #include "pico/stdlib.h"
+#include "pico/critical_section.h"
 #include "hardware/gpio.h"
 #include "hardware/pwm.h"
 #include "hardware/clocks.h"
@@ -10,7 +11,39 @@
 #define BUZZER_PIN_0 10
 #define BUZZER_PIN 21
 
+#define BUZZER_QUEUE_LEN 4      // Padrões aguardando atrás do que está tocando
+
+// Um tom: frequência (0 = silêncio), tempo ligado e pausa depois dele
+typedef struct {
+    uint16_t freq_hz;
+    uint16_t on_ms;
+    uint16_t off_ms;
+} buzzer_tone_t;
+
+// Sequência de tons repetida 'repeats' vezes. 'tones' precisa continuar
+// válido enquanto o padrão toca (use tabelas const estáticas).
+typedef struct {
+    const buzzer_tone_t *tones;
+    uint8_t count;
+    uint8_t repeats;
+    uint8_t priority;           // Maior interrompe o atual; menor ou igual entra na fila
+} buzzer_pattern_t;
+
+typedef struct {
+    uint32_t played;
+    uint32_t preempted;         // Padrões interrompidos ou retirados da fila por um mais prioritário
+    uint32_t dropped;           // Recusados com a fila cheia ou sem alarme livre
+    uint64_t callback_us;       // Tempo total dentro dos alarmes do sequenciador
+    uint32_t callback_max_us;
+    uint64_t blocking_us;       // Tempo total bloqueado em buzzer_play
+} buzzer_stats_t;
+
 void buzzer_setup_pwm(uint pin, uint freq_hz);
 void buzzer_play(uint pin, uint times, uint freq_hz, uint duration_ms);
 
-#endif
\ No newline at end of file
+void buzzer_set_alarm_pool(alarm_pool_t *pool);
+bool buzzer_submit(const buzzer_pattern_t *pattern);
+bool buzzer_busy(void);
+void buzzer_get_stats(buzzer_stats_t *stats);
+
+#endif
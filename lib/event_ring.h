@@ -0,0 +1,78 @@
+#ifndef EVENT_RING_H
+#define EVENT_RING_H
+
+// Fila circular sem lock para um produtor (a ISR) e um consumidor (uma
+// tarefa). head só é escrito pelo produtor e tail só pelo consumidor; as
+// barreiras acquire/release garantem que o registro está completo antes de
+// o índice ficar visível para o outro lado.
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define EVENT_RING_SIZE 64                  // Potência de 2
+#define EVENT_RING_MASK (EVENT_RING_SIZE - 1)
+
+typedef struct {
+    uint32_t timestamp_us;                  // Instante da borda (time_us_32)
+    uint32_t irq_us;                        // Instante da interrupção que a entregou (latência)
+    uint8_t gpio;
+    uint8_t kind;
+    uint8_t lane;                           // Pista de origem (definida pela aplicação)
+} event_t;
+
+typedef struct {
+    event_t buf[EVENT_RING_SIZE];
+    _Atomic uint32_t head;                  // Próxima posição livre (produtor)
+    _Atomic uint32_t tail;                  // Próximo registro a consumir (consumidor)
+    uint32_t overflows;                     // Eventos recusados com a fila cheia
+    uint32_t high_water;                    // Maior ocupação observada
+} event_ring_t;
+
+static inline void event_ring_init(event_ring_t *ring) {
+    atomic_store_explicit(&ring->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, 0, memory_order_relaxed);
+    ring->overflows = 0;
+    ring->high_water = 0;
+}
+
+// Lado do produtor. Nunca bloqueia; com a fila cheia o evento é contado em
+// 'overflows' e descartado.
+static inline bool event_ring_push(event_ring_t *ring, const event_t *ev) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint32_t used = head - tail;
+
+    if (used >= EVENT_RING_SIZE) {
+        ring->overflows++;
+        return false;
+    }
+    ring->buf[head & EVENT_RING_MASK] = *ev;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    if (used + 1 > ring->high_water)
+        ring->high_water = used + 1;
+    return true;
+}
+
+// Lado do consumidor: copia até 'max' eventos, na ordem de chegada
+static inline size_t event_ring_pop_batch(event_ring_t *ring, event_t *out, size_t max) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    size_t n = head - tail;
+
+    if (n > max)
+        n = max;
+    for (size_t i = 0; i < n; ++i)
+        out[i] = ring->buf[(tail + i) & EVENT_RING_MASK];
+    atomic_store_explicit(&ring->tail, tail + (uint32_t)n, memory_order_release);
+    return n;
+}
+
+static inline size_t event_ring_count(event_ring_t *ring) {
+    return atomic_load_explicit(&ring->head, memory_order_acquire) -
+           atomic_load_explicit(&ring->tail, memory_order_acquire);
+}
+
+#endif
@@ -0,0 +1,382 @@
+#include <string.h>
+
+#include "journal.h"
+
+#if PICO_ON_DEVICE
+#include "hardware/flash.h"
+#include "pico/flash.h"
+#endif
+
+#define REC_SIZE sizeof(journal_rec_t)
+
+static uint32_t journal_crc32(const void *data, size_t len) {
+    const uint8_t *p = data;
+    uint32_t crc = 0xFFFFFFFFu;
+
+    while (len--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; ++k)
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+    return ~crc;
+}
+
+static uint32_t rec_crc(const journal_rec_t *r) {
+    return journal_crc32(r, offsetof(journal_rec_t, crc));
+}
+
+static bool rec_valid(const journal_t *j, const journal_rec_t *r) {
+    return r->crc == rec_crc(r) && r->kind >= JOURNAL_DELTA && r->kind <= JOURNAL_CHECKPOINT &&
+           r->key < j->num_keys;
+}
+
+static bool rec_erased(const journal_rec_t *r) {
+    const uint8_t *p = (const uint8_t *)r;
+    for (size_t i = 0; i < REC_SIZE; ++i)
+        if (p[i] != 0xFF)
+            return false;
+    return true;
+}
+
+static inline uint32_t recs_per_sector(const journal_t *j) {
+    return j->flash->sector_size / REC_SIZE;
+}
+
+static inline uint32_t recs_per_page(const journal_t *j) {
+    return j->flash->page_size / REC_SIZE;
+}
+
+static void read_rec(const journal_t *j, uint32_t sector, uint32_t slot, journal_rec_t *r) {
+    j->flash->read(j->flash->ctx, sector * j->flash->sector_size + slot * REC_SIZE, r, REC_SIZE);
+}
+
+static void apply(int32_t *state, const journal_rec_t *r) {
+    if (r->kind == JOURNAL_DELTA)
+        state[r->key] += r->value;
+    else
+        state[r->key] = r->value;
+}
+
+
+// Setor válido mais recente com seq anterior a 'limit' (se has_limit)
+static bool find_sector(journal_t *j, bool has_limit, uint32_t limit, uint32_t *sector, uint32_t *seq) {
+    bool found = false;
+    journal_rec_t r;
+
+    for (uint32_t s = 0; s < j->flash->num_sectors; ++s) {
+        read_rec(j, s, 0, &r);
+        if (!rec_valid(j, &r) || r.kind != JOURNAL_CHECKPOINT)
+            continue;
+        if (has_limit && (int32_t)(r.seq - limit) >= 0)
+            continue;
+        if (!found || (int32_t)(r.seq - *seq) > 0) {
+            found = true;
+            *sector = s;
+            *seq = r.seq;
+        }
+    }
+    return found;
+}
+
+// Reexecuta o setor a partir do checkpoint. Retorna false se o checkpoint
+// está incompleto (energia cortada enquanto o setor começava).
+static bool replay_sector(journal_t *j, uint32_t sector, uint32_t seq) {
+    uint32_t per_sector = recs_per_sector(j);
+    bool torn = false;
+    uint32_t slot;
+    journal_rec_t r;
+
+    memset(j->state, 0, sizeof(j->state));
+    j->seq = seq;
+    for (slot = 0; slot < per_sector; ++slot) {
+        read_rec(j, sector, slot, &r);
+        if (rec_erased(&r))
+            break;
+        if (!rec_valid(j, &r) || r.seq != j->seq || (slot < j->num_keys && r.kind != JOURNAL_CHECKPOINT)) {
+            torn = true;
+            break;
+        }
+        apply(j->state, &r);
+        j->seq++;
+    }
+    if (slot < j->num_keys)
+        return false;
+
+    j->stats.replayed = slot;
+    j->sector = sector;
+    j->slot = torn ? per_sector : slot;     // Registro incompleto: segue num setor novo
+    if (j->slot < per_sector) {
+        uint32_t page_slot = j->slot - j->slot % recs_per_page(j);
+        j->flash->read(j->flash->ctx, sector * j->flash->sector_size + page_slot * REC_SIZE, j->page,
+                       j->flash->page_size);
+    }
+    return true;
+}
+
+
+// Monta o journal e restaura o estado gravado. Lê o primeiro registro de
+// cada setor e reexecuta só o setor mais recente.
+bool journal_init(journal_t *j, const journal_flash_t *flash, uint8_t num_keys) {
+    uint32_t sector = 0, seq = 0;
+    bool has_limit = false;
+
+    if (num_keys == 0 || num_keys > JOURNAL_MAX_KEYS || flash->num_sectors < 2 ||
+        flash->page_size > JOURNAL_PAGE_MAX || flash->page_size % REC_SIZE != 0 ||
+        flash->sector_size % flash->page_size != 0 || flash->sector_size / REC_SIZE <= num_keys)
+        return false;
+
+    memset(j, 0, sizeof(*j));
+    j->flash = flash;
+    j->num_keys = num_keys;
+    critical_section_init(&j->lock);
+
+    while (find_sector(j, has_limit, seq, &sector, &seq)) {
+        if (replay_sector(j, sector, seq)) {
+            memcpy(j->live, j->state, sizeof(j->live));
+            return true;
+        }
+        has_limit = true;       // Tenta o setor anterior
+    }
+
+    // Journal vazio: o primeiro commit começa no setor 0
+    memset(j->state, 0, sizeof(j->state));
+    memset(j->live, 0, sizeof(j->live));
+    j->seq = 0;
+    j->sector = flash->num_sectors - 1;
+    j->slot = recs_per_sector(j);
+    return true;
+}
+
+
+int32_t journal_state(const journal_t *j, uint8_t key) {
+    return key < j->num_keys ? j->state[key] : 0;
+}
+
+
+// Não bloqueia nem toca na flash: com a área de preparo cheia o registro é
+// contado em 'dropped' e a chave fica marcada. O valor vivo já inclui o
+// registro, então o SET do próximo commit recupera o que ficou de fora.
+bool journal_append(journal_t *j, journal_kind_t kind, uint8_t key, int16_t value, uint32_t timestamp) {
+    bool ok = false;
+    journal_rec_t rec = { .kind = (uint8_t)kind, .key = key, .value = value, .timestamp = timestamp };
+
+    if (key >= j->num_keys)
+        return false;
+
+    critical_section_enter_blocking(&j->lock);
+    apply(j->live, &rec);
+    if (j->pending < JOURNAL_STAGING) {
+        j->staging[j->pending++] = rec;
+        j->stats.appended++;
+        ok = true;
+    } else {
+        j->dirty |= 1u << key;
+        j->stats.dropped++;
+    }
+    critical_section_exit(&j->lock);
+    return ok;
+}
+
+
+// Registros preparados mais os SETs das chaves marcadas
+size_t journal_pending(journal_t *j) {
+    critical_section_enter_blocking(&j->lock);
+    size_t n = j->pending + (size_t)__builtin_popcount(j->dirty);
+    critical_section_exit(&j->lock);
+    return n;
+}
+
+
+// Grava a página do último registro (os registros anteriores dela já estão
+// na flash e são regravados iguais)
+static bool flush_page(journal_t *j) {
+    if (!j->page_dirty)
+        return true;
+
+    uint32_t page = (j->slot - 1) / recs_per_page(j);
+    uint32_t offset = j->sector * j->flash->sector_size + page * j->flash->page_size;
+    j->page_dirty = false;
+    return j->flash->program(j->flash->ctx, offset, j->page);
+}
+
+static bool write_rec(journal_t *j, journal_rec_t *r);
+
+// Passa para o próximo setor (apagando-o, se journal_prepare ainda não o
+// fez) e grava o checkpoint do estado atual
+static bool start_sector(journal_t *j) {
+    uint32_t next = (j->sector + 1) % j->flash->num_sectors;
+
+    if (!flush_page(j))
+        return false;
+    if (!j->next_erased) {
+        if (!j->flash->erase(j->flash->ctx, next * j->flash->sector_size))
+            return false;
+        j->stats.erases++;
+    }
+    j->next_erased = false;
+    j->sector = next;
+    j->slot = 0;
+
+    for (uint8_t key = 0; key < j->num_keys; ++key) {
+        journal_rec_t cp = { .kind = JOURNAL_CHECKPOINT, .key = key, .value = (int16_t)j->state[key] };
+        if (!write_rec(j, &cp))
+            return false;
+    }
+    return true;
+}
+
+static bool write_rec(journal_t *j, journal_rec_t *r) {
+    uint32_t per_page = recs_per_page(j);
+
+    if (j->slot >= recs_per_sector(j) && !start_sector(j))
+        return false;
+
+    uint32_t in_page = j->slot % per_page;
+    if (in_page == 0) {
+        if (!flush_page(j))
+            return false;
+        memset(j->page, 0xFF, j->flash->page_size);
+    }
+
+    r->seq = j->seq;
+    r->crc = rec_crc(r);
+    memcpy(j->page + in_page * REC_SIZE, r, REC_SIZE);
+    j->page_dirty = true;
+    j->slot++;
+    j->seq++;
+    apply(j->state, r);
+    return true;
+}
+
+
+// Devolve batch[from..n) ao início da área de preparo, antes do que chegou
+// durante o commit. O que não couber só marca a chave: o SET do próximo
+// commit leva o valor vivo dela.
+static void requeue(journal_t *j, size_t from, size_t n) {
+    size_t back = n - from;
+
+    critical_section_enter_blocking(&j->lock);
+    size_t total = back + j->pending;
+    for (size_t i = JOURNAL_STAGING; i < total; ++i) {
+        const journal_rec_t *r = i < back ? &j->batch[from + i] : &j->staging[i - back];
+        j->dirty |= 1u << r->key;
+    }
+    size_t kept_back = back < JOURNAL_STAGING ? back : JOURNAL_STAGING;
+    size_t kept_pending = total > JOURNAL_STAGING ? JOURNAL_STAGING - kept_back : j->pending;
+    memmove(&j->staging[kept_back], j->staging, kept_pending * REC_SIZE);
+    memcpy(j->staging, &j->batch[from], kept_back * REC_SIZE);
+    j->pending = (uint16_t)(kept_back + kept_pending);
+    j->stats.requeued += kept_back;
+    critical_section_exit(&j->lock);
+}
+
+
+// Grava tudo o que está na área de preparo e um SET por chave marcada, uma
+// gravação por página tocada. Retorna quantos registros chegaram à flash;
+// numa falha nada é perdido e o próximo commit tenta de novo.
+size_t journal_commit(journal_t *j) {
+    size_t n, written = 0;
+
+    critical_section_enter_blocking(&j->lock);
+    n = j->pending;
+    memcpy(j->batch, j->staging, n * REC_SIZE);
+    j->pending = 0;
+    for (uint8_t key = 0; key < j->num_keys; ++key) {
+        if (j->dirty & (1u << key)) {
+            uint32_t timestamp = n ? j->batch[n - 1].timestamp : 0;
+            j->batch[n++] = (journal_rec_t){ .kind = JOURNAL_SET, .key = key,
+                                             .value = (int16_t)j->live[key], .timestamp = timestamp };
+        }
+    }
+    j->dirty = 0;
+    critical_section_exit(&j->lock);
+
+    if (n == 0)
+        return 0;
+
+    while (written < n && write_rec(j, &j->batch[written]))
+        ++written;
+    if (written < n || !flush_page(j)) {
+        // Página em estado desconhecido: o próximo commit abre um setor novo,
+        // cujo checkpoint já inclui o que foi aplicado aqui. O resto do lote
+        // volta para a área de preparo.
+        j->page_dirty = false;
+        j->slot = recs_per_sector(j);
+        j->next_erased = false;
+        j->stats.errors++;
+        requeue(j, written, n);
+        return 0;
+    }
+
+    j->stats.commits++;
+    j->stats.committed += written;
+    return written;
+}
+
+
+// Apaga o próximo setor com antecedência, para que a troca de setor dentro
+// de um commit custe só gravações. Chamar com a área de preparo vazia.
+void journal_prepare(journal_t *j) {
+    if (j->next_erased || j->slot >= recs_per_sector(j))
+        return;
+
+    uint32_t next = (j->sector + 1) % j->flash->num_sectors;
+    if (j->flash->erase(j->flash->ctx, next * j->flash->sector_size)) {
+        j->next_erased = true;
+        j->stats.erases++;
+    } else {
+        j->stats.errors++;
+    }
+}
+
+
+void journal_get_stats(journal_t *j, journal_stats_t *stats) {
+    critical_section_enter_blocking(&j->lock);
+    *stats = j->stats;
+    critical_section_exit(&j->lock);
+}
+
+
+#if PICO_ON_DEVICE
+// Backend da flash do próprio RP2040. Apagar/gravar desliga o XIP, então
+// flash_safe_execute desabilita as interrupções deste núcleo e pausa o
+// outro durante a operação (uma página leva ~1 ms, um setor dezenas de ms).
+typedef struct {
+    uint32_t offset;
+    const uint8_t *page;
+} rp2040_op_t;
+
+static void rp2040_do_program(void *param) {
+    const rp2040_op_t *op = param;
+    flash_range_program(op->offset, op->page, FLASH_PAGE_SIZE);
+}
+
+static void rp2040_do_erase(void *param) {
+    const rp2040_op_t *op = param;
+    flash_range_erase(op->offset, FLASH_SECTOR_SIZE);
+}
+
+static void rp2040_read(void *ctx, uint32_t offset, void *buf, size_t len) {
+    memcpy(buf, (const uint8_t *)XIP_BASE + (uintptr_t)ctx + offset, len);
+}
+
+static bool rp2040_program(void *ctx, uint32_t offset, const uint8_t *page) {
+    rp2040_op_t op = { (uint32_t)(uintptr_t)ctx + offset, page };
+    return flash_safe_execute(rp2040_do_program, &op, UINT32_MAX) == PICO_OK;
+}
+
+static bool rp2040_erase(void *ctx, uint32_t offset) {
+    rp2040_op_t op = { (uint32_t)(uintptr_t)ctx + offset, NULL };
+    return flash_safe_execute(rp2040_do_erase, &op, UINT32_MAX) == PICO_OK;
+}
+
+void journal_flash_rp2040(journal_flash_t *flash, uint32_t offset, uint32_t num_sectors) {
+    flash->sector_size = FLASH_SECTOR_SIZE;
+    flash->page_size = FLASH_PAGE_SIZE;
+    flash->num_sectors = num_sectors;
+    flash->read = rp2040_read;
+    flash->program = rp2040_program;
+    flash->erase = rp2040_erase;
+    flash->ctx = (void *)(uintptr_t)offset;
+}
+#endif
@@ -0,0 +1,97 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+// Journal só de acréscimo numa região reservada da flash. Os registros têm
+// 16 bytes, cada um com seu CRC, e são gravados em sequência pelos setores
+// da região, em círculo: cada setor só é apagado uma vez por volta. Todo
+// setor começa com um checkpoint do estado (um registro por chave), então a
+// restauração lê o primeiro registro de cada setor e reexecuta no máximo um
+// setor de registros.
+//
+// Quem produz eventos só copia o registro para a área de preparo em RAM
+// (journal_append); a gravação acontece em journal_commit, chamado por uma
+// tarefa de baixa prioridade. Com a área de preparo cheia a chave fica
+// marcada e o próximo commit grava um SET com o valor vivo dela, e os
+// registros de um commit que falhou voltam para a área de preparo.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pico/stdlib.h"
+#include "pico/critical_section.h"
+
+#define JOURNAL_MAX_KEYS 8
+#define JOURNAL_STAGING 32          // Registros aguardando gravação
+#define JOURNAL_PAGE_MAX 256
+
+typedef enum {
+    JOURNAL_DELTA = 1,              // estado[chave] += valor
+    JOURNAL_SET = 2,                // estado[chave] = valor
+    JOURNAL_CHECKPOINT = 3,         // Igual a SET, no início de cada setor
+} journal_kind_t;
+
+typedef struct {
+    uint32_t seq;                   // Contínuo em todo o journal
+    uint32_t timestamp;
+    uint8_t kind;
+    uint8_t key;
+    int16_t value;
+    uint32_t crc;
+} journal_rec_t;
+
+// Operações da flash. 'program' recebe uma página inteira e alinhada; bits
+// já gravados recebem 1 e ficam como estão (NOR), o que permite completar
+// uma página em várias gravações.
+typedef struct {
+    uint32_t sector_size;
+    uint32_t page_size;
+    uint32_t num_sectors;
+    void (*read)(void *ctx, uint32_t offset, void *buf, size_t len);
+    bool (*program)(void *ctx, uint32_t offset, const uint8_t *page);
+    bool (*erase)(void *ctx, uint32_t offset);
+    void *ctx;
+} journal_flash_t;
+
+typedef struct {
+    uint32_t appended;
+    uint32_t committed;
+    uint32_t dropped;               // Área de preparo cheia (vira SET no próximo commit)
+    uint32_t requeued;              // Devolvidos à área de preparo por um commit falho
+    uint32_t commits;
+    uint32_t erases;
+    uint32_t replayed;              // Registros reexecutados na restauração
+    uint32_t errors;                // Falhas de gravação/apagamento
+} journal_stats_t;
+
+typedef struct {
+    const journal_flash_t *flash;
+    uint8_t num_keys;
+    critical_section_t lock;
+    journal_rec_t staging[JOURNAL_STAGING];
+    uint16_t pending;
+    uint8_t dirty;                  // Chaves com registros descartados (bit por chave)
+    int32_t live[JOURNAL_MAX_KEYS];         // Estado com tudo o que foi acrescentado
+    journal_rec_t batch[JOURNAL_STAGING + JOURNAL_MAX_KEYS];   // Cópia usada pelo commit
+    int32_t state[JOURNAL_MAX_KEYS];        // Estado do que já está na flash
+    uint32_t seq;                   // Próximo número de sequência
+    uint32_t sector;                // Setor atual
+    uint32_t slot;                  // Próxima posição livre no setor
+    bool next_erased;               // Próximo setor já apagado (journal_prepare)
+    uint8_t page[JOURNAL_PAGE_MAX]; // Página do último registro, como estará na flash
+    bool page_dirty;
+    journal_stats_t stats;
+} journal_t;
+
+bool journal_init(journal_t *j, const journal_flash_t *flash, uint8_t num_keys);
+int32_t journal_state(const journal_t *j, uint8_t key);
+bool journal_append(journal_t *j, journal_kind_t kind, uint8_t key, int16_t value, uint32_t timestamp);
+size_t journal_pending(journal_t *j);
+size_t journal_commit(journal_t *j);
+void journal_prepare(journal_t *j);
+void journal_get_stats(journal_t *j, journal_stats_t *stats);
+
+// Região da flash do RP2040 ('offset' a partir do início da flash, alinhado
+// a setor). No build do host o HAL simulado fornece uma flash em RAM.
+void journal_flash_rp2040(journal_flash_t *flash, uint32_t offset, uint32_t num_sectors);
+
+#endif
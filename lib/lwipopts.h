@@ -0,0 +1,59 @@
+#ifndef LWIPOPTS_H
+#define LWIPOPTS_H
+
+// Opções do lwIP para o status pela rede (CONTROLE_VAGA_REDE): API raw com
+// a thread tcpip no FreeRTOS (pico_cyw43_arch_lwip_sys_freertos). Só
+// respostas curtas saem, então os buffers são pequenos; sem sockets nem
+// netconn.
+
+#define NO_SYS                      0
+#define LWIP_SOCKET                 0
+#define LWIP_NETCONN                0
+#define LWIP_TCPIP_CORE_LOCKING     1
+#define LWIP_TIMEVAL_PRIVATE        0
+
+#define MEM_LIBC_MALLOC             0
+#define MEM_ALIGNMENT               4
+#define MEM_SIZE                    8000
+#define MEMP_NUM_TCP_SEG            16
+#define MEMP_NUM_TCP_PCB            4       // Respostas fecham logo a conexão
+#define MEMP_NUM_ARP_QUEUE          10
+#define PBUF_POOL_SIZE              16
+
+#define LWIP_ARP                    1
+#define LWIP_ETHERNET               1
+#define LWIP_ICMP                   1
+#define LWIP_RAW                    0
+#define LWIP_IPV4                   1
+#define LWIP_TCP                    1
+#define LWIP_UDP                    1
+#define LWIP_DNS                    0
+#define LWIP_DHCP                   1
+#define DHCP_DOES_ARP_CHECK         0
+#define LWIP_DHCP_DOES_ACD_CHECK    0
+#define LWIP_TCP_KEEPALIVE          0
+
+#define TCP_MSS                     1460
+#define TCP_WND                     (2 * TCP_MSS)
+#define TCP_SND_BUF                 (2 * TCP_MSS)
+#define TCP_SND_QUEUELEN            ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
+
+#define LWIP_NETIF_STATUS_CALLBACK  1
+#define LWIP_NETIF_LINK_CALLBACK    1
+#define LWIP_NETIF_HOSTNAME         1
+#define LWIP_NETIF_TX_SINGLE_PBUF   1
+
+#define TCPIP_THREAD_STACKSIZE      1024
+#define TCPIP_THREAD_PRIO           1       // Mesma prioridade das tarefas de eventos
+#define TCPIP_MBOX_SIZE             8
+#define DEFAULT_THREAD_STACKSIZE    1024
+#define DEFAULT_RAW_RECVMBOX_SIZE   8
+#define DEFAULT_UDP_RECVMBOX_SIZE   8
+#define DEFAULT_TCP_RECVMBOX_SIZE   8
+#define DEFAULT_ACCEPTMBOX_SIZE     8
+
+#define LWIP_STATS                  0
+#define LWIP_STATS_DISPLAY          0
+#define LWIP_DEBUG                  0
+
+#endif
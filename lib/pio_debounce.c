@@ -0,0 +1,94 @@
+#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+
+#include "pio_debounce.h"
+#include "pio_debounce.pio.h"
+
+static struct {
+    PIO pio;
+    uint sm;
+    uint gpio;
+} pins[PIO_DEBOUNCE_MAX_PINS];
+static uint num_pins;
+static int program_offset[2] = { -1, -1 };
+static uint32_t window_us;
+static pio_debounce_cb_t callback;
+
+
+void pio_debounce_init(uint32_t window, pio_debounce_cb_t cb) {
+    window_us = window;
+    callback = cb;
+}
+
+
+// RX FIFO não vazia em qualquer máquina: cada palavra é uma borda que ficou
+// estável por window_us, então a descida aconteceu window_us antes. O
+// callback recebe os dois instantes: a latência conta a partir de now.
+static void pio_debounce_irq_handler(void) {
+    uint32_t now = time_us_32();
+
+    for (uint i = 0; i < num_pins; ++i) {
+        while (!pio_sm_is_rx_fifo_empty(pins[i].pio, pins[i].sm)) {
+            (void)pio_sm_get(pins[i].pio, pins[i].sm);
+            callback(pins[i].gpio, now - window_us, now);
+        }
+    }
+}
+
+
+static bool pio_debounce_claim(PIO *pio, uint *sm) {
+    PIO candidates[2] = { pio0, pio1 };
+
+    for (uint i = 0; i < 2; ++i) {
+        int claimed = pio_claim_unused_sm(candidates[i], false);
+        if (claimed < 0)
+            continue;
+        if (program_offset[i] < 0) {
+            if (!pio_can_add_program(candidates[i], &pio_debounce_program)) {
+                pio_sm_unclaim(candidates[i], (uint)claimed);
+                continue;
+            }
+            program_offset[i] = (int)pio_add_program(candidates[i], &pio_debounce_program);
+
+            uint irq = i == 0 ? PIO0_IRQ_0 : PIO1_IRQ_0;
+            irq_set_exclusive_handler(irq, pio_debounce_irq_handler);
+            irq_set_enabled(irq, true);
+        }
+        *pio = candidates[i];
+        *sm = (uint)claimed;
+        return true;
+    }
+    return false;
+}
+
+
+// Liga uma máquina à entrada (que continua com a função e o pull-up de GPIO)
+bool pio_debounce_add_pin(uint gpio) {
+    PIO pio;
+    uint sm;
+
+    if (num_pins == PIO_DEBOUNCE_MAX_PINS || !pio_debounce_claim(&pio, &sm))
+        return false;
+
+    uint offset = (uint)program_offset[pio_get_index(pio)];
+    pio_sm_config c = pio_debounce_program_get_default_config(offset);
+    sm_config_set_in_pins(&c, gpio);
+    sm_config_set_jmp_pin(&c, gpio);
+    sm_config_set_clkdiv(&c, (float)clock_get_hz(clk_sys) / PIO_DEBOUNCE_TICK_HZ);
+    pio_sm_init(pio, sm, offset, &c);
+
+    // Janela em voltas de 2 ciclos, carregada em Y antes de a máquina rodar
+    pio_sm_put(pio, sm, window_us * (PIO_DEBOUNCE_TICK_HZ / 1000000) / 2);
+    pio_sm_exec(pio, sm, pio_encode_pull(false, false));
+    pio_sm_exec(pio, sm, pio_encode_mov(pio_y, pio_osr));
+
+    pins[num_pins].pio = pio;
+    pins[num_pins].sm = sm;
+    pins[num_pins].gpio = gpio;
+    num_pins++;
+
+    pio_set_irq0_source_enabled(pio, (enum pio_interrupt_source)(pis_sm0_rx_fifo_not_empty + sm), true);
+    pio_sm_set_enabled(pio, sm, true);
+    return true;
+}
@@ -0,0 +1,21 @@
+#ifndef PIO_DEBOUNCE_H
+#define PIO_DEBOUNCE_H
+
+// Debounce por hardware: uma máquina de estados do PIO por entrada filtra a
+// trepidação com uma janela configurável e só gera interrupção para bordas
+// limpas. O handler da FIFO carimba o instante da borda e o da interrupção e
+// chama o callback.
+
+#include "pico/stdlib.h"
+
+#define PIO_DEBOUNCE_MAX_PINS 8         // 4 máquinas em cada PIO
+#define PIO_DEBOUNCE_TICK_HZ 1000000    // Clock das máquinas: uma volta do laço = 2 us
+
+// Chamado em contexto de interrupção com o instante estimado da descida e o
+// da interrupção, uma janela depois
+typedef void (*pio_debounce_cb_t)(uint gpio, uint32_t edge_us, uint32_t irq_us);
+
+void pio_debounce_init(uint32_t window_us, pio_debounce_cb_t callback);
+bool pio_debounce_add_pin(uint gpio);
+
+#endif
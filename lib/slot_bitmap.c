@@ -0,0 +1,83 @@
+#include "slot_bitmap.h"
+
+// No RP2040 o __builtin_clz vira a rotina da ROM (pico_bit_ops), sem laço
+#define BIT(i) (0x80000000u >> ((i) & 31u))
+
+
+bool slot_bitmap_init(slot_bitmap_t *bm, uint32_t *words, uint32_t *summary, uint32_t capacity) {
+    if (capacity == 0 || capacity > SLOT_BITMAP_MAX) {
+        return false;
+    }
+    bm->words = words;
+    bm->summary = summary;
+    bm->capacity = capacity;
+    slot_bitmap_clear(bm);
+    return true;
+}
+
+
+// Todas as vagas livres
+void slot_bitmap_clear(slot_bitmap_t *bm) {
+    uint32_t n_words = SLOT_BITMAP_WORDS(bm->capacity);
+    uint32_t n_summary = SLOT_BITMAP_SUMMARY(bm->capacity);
+
+    for (uint32_t w = 0; w < n_words; w++) {
+        uint32_t resto = bm->capacity - w * 32u;
+        bm->words[w] = resto >= 32u ? 0xFFFFFFFFu : ~(0xFFFFFFFFu >> resto);
+    }
+    for (uint32_t s = 0; s < n_summary; s++) {
+        uint32_t resto = n_words - s * 32u;
+        bm->summary[s] = resto >= 32u ? 0xFFFFFFFFu : ~(0xFFFFFFFFu >> resto);
+    }
+    bm->root = n_summary >= 32u ? 0xFFFFFFFFu : ~(0xFFFFFFFFu >> n_summary);
+    bm->free = bm->capacity;
+}
+
+
+// Apaga o bit da vaga e propaga para cima as palavras que esvaziaram
+static void marca_ocupada(slot_bitmap_t *bm, uint32_t slot) {
+    uint32_t w = slot >> 5;
+
+    bm->words[w] &= ~BIT(slot);
+    if (bm->words[w] == 0) {
+        bm->summary[w >> 5] &= ~BIT(w);
+        if (bm->summary[w >> 5] == 0) {
+            bm->root &= ~BIT(w >> 5);
+        }
+    }
+    bm->free--;
+}
+
+
+// Menor índice livre, ou SLOT_BITMAP_NONE com tudo ocupado
+int32_t slot_bitmap_alloc(slot_bitmap_t *bm) {
+    if (bm->root == 0) {
+        return SLOT_BITMAP_NONE;
+    }
+    uint32_t s = __builtin_clz(bm->root);
+    uint32_t w = (s << 5) + __builtin_clz(bm->summary[s]);
+    uint32_t slot = (w << 5) + __builtin_clz(bm->words[w]);
+
+    marca_ocupada(bm, slot);
+    return (int32_t)slot;
+}
+
+
+// Libera a vaga; falso se ela já estava livre
+bool slot_bitmap_release(slot_bitmap_t *bm, uint32_t slot) {
+    if (slot >= bm->capacity || slot_bitmap_is_free(bm, slot)) {
+        return false;
+    }
+    uint32_t w = slot >> 5;
+
+    bm->words[w] |= BIT(slot);
+    bm->summary[w >> 5] |= BIT(w);
+    bm->root |= BIT(w >> 5);
+    bm->free++;
+    return true;
+}
+
+
+bool slot_bitmap_is_free(const slot_bitmap_t *bm, uint32_t slot) {
+    return slot < bm->capacity && (bm->words[slot >> 5] & BIT(slot)) != 0;
+}
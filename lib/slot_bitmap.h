@@ -0,0 +1,36 @@
+#ifndef SLOT_BITMAP_H
+#define SLOT_BITMAP_H
+
+// Mapa de bits de vagas em três níveis: um bit por vaga (1 = livre), um bit
+// de resumo por palavra de vagas com alguma livre e uma palavra raiz com um
+// bit por palavra de resumo não vazia. Achar a primeira vaga livre são três
+// count-leading-zeros, qualquer que seja a capacidade (até 32768 vagas).
+// O bit mais significativo é o menor índice, então o clz já dá a posição.
+//
+// A memória das palavras vem de quem chama (SLOT_BITMAP_WORDS e
+// SLOT_BITMAP_SUMMARY dão os tamanhos). Não há lock: quem compartilha o
+// mapa entre tarefas serializa o acesso.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SLOT_BITMAP_MAX (32u * 32u * 32u)
+#define SLOT_BITMAP_WORDS(capacity) (((capacity) + 31u) / 32u)
+#define SLOT_BITMAP_SUMMARY(capacity) ((SLOT_BITMAP_WORDS(capacity) + 31u) / 32u)
+#define SLOT_BITMAP_NONE (-1)
+
+typedef struct {
+    uint32_t *words;
+    uint32_t *summary;
+    uint32_t root;
+    uint32_t capacity;
+    uint32_t free;
+} slot_bitmap_t;
+
+bool slot_bitmap_init(slot_bitmap_t *bm, uint32_t *words, uint32_t *summary, uint32_t capacity);
+int32_t slot_bitmap_alloc(slot_bitmap_t *bm);
+bool slot_bitmap_release(slot_bitmap_t *bm, uint32_t slot);
+bool slot_bitmap_is_free(const slot_bitmap_t *bm, uint32_t slot);
+void slot_bitmap_clear(slot_bitmap_t *bm);
+
+#endif
@@ -1,120 +1,411 @@
+#include <string.h>
 #include "ssd1306.h"
 #include "font.h"
 
-void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
+static void ssd1306_setup(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, const ssd1306_bus_t *bus) {
   ssd->width = width;
   ssd->height = height;
   ssd->pages = height / 8U;
-  ssd->address = address;
-  ssd->i2c_port = i2c;
+  ssd->external_vcc = external_vcc;
+  ssd->bus = bus;
   ssd->bufsize = ssd->pages * ssd->width + 1;
-  ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+}
+
+static inline void ssd1306_clear_dirty(uint8_t *x0, uint8_t *x1, uint8_t pages) {
+  for (uint8_t p = 0; p < pages; ++p) {
+    x0[p] = 0xFF;
+    x1[p] = 0;
+  }
+}
+
+// Buffers já alocados (e zerados): back, front, sombra e fluxo do barramento
+static void ssd1306_init_buffers(ssd1306_t *ssd, uint8_t *ram, uint8_t *front, uint8_t *shadow, uint8_t *stream) {
+  ssd->ram_buffer = ram;
   ssd->ram_buffer[0] = 0x40;
-  ssd->port_buffer[0] = 0x80;
+  ssd->front_buffer = front;
+  ssd->shadow_buffer = shadow;
+  ssd->stream = stream;
+  ssd->stats = (ssd1306_stats_t){0};
+  ssd->busy = false;
+  ssd->pending = false;
+  critical_section_init(&ssd->lock);
+  ssd1306_clear_dirty(ssd->front_x0, ssd->front_x1, ssd->pages);
+  ssd1306_invalidate(ssd);
+}
+
+void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, const ssd1306_bus_t *bus) {
+  ssd1306_setup(ssd, width, height, external_vcc, bus);
+  ssd1306_init_buffers(ssd, calloc(ssd->bufsize, sizeof(uint8_t)), calloc(ssd->bufsize, sizeof(uint8_t)),
+                       calloc(ssd->bufsize, sizeof(uint8_t)), calloc(SSD1306_STREAM_MAX(ssd->bufsize), sizeof(uint8_t)));
+}
+
+// Sem heap: a memória vem de quem chama (até WIDTH x HEIGHT)
+void ssd1306_init_static(ssd1306_t *ssd, ssd1306_buffers_t *buffers, uint8_t width, uint8_t height, bool external_vcc,
+                         const ssd1306_bus_t *bus) {
+  ssd1306_setup(ssd, width, height, external_vcc, bus);
+  memset(buffers, 0, sizeof(*buffers));
+  ssd1306_init_buffers(ssd, buffers->ram, buffers->front, buffers->shadow, buffers->stream);
 }
 
+// Toda a configuração numa só transação de comandos
 void ssd1306_config(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_DISP | 0x00);
-  ssd1306_command(ssd, SET_MEM_ADDR);
-  ssd1306_command(ssd, 0x01);
-  ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
-  ssd1306_command(ssd, SET_SEG_REMAP | 0x01);
-  ssd1306_command(ssd, SET_MUX_RATIO);
-  ssd1306_command(ssd, HEIGHT - 1);
-  ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);
-  ssd1306_command(ssd, SET_DISP_OFFSET);
-  ssd1306_command(ssd, 0x00);
-  ssd1306_command(ssd, SET_COM_PIN_CFG);
-  ssd1306_command(ssd, 0x12);
-  ssd1306_command(ssd, SET_DISP_CLK_DIV);
-  ssd1306_command(ssd, 0x80);
-  ssd1306_command(ssd, SET_PRECHARGE);
-  ssd1306_command(ssd, 0xF1);
-  ssd1306_command(ssd, SET_VCOM_DESEL);
-  ssd1306_command(ssd, 0x30);
-  ssd1306_command(ssd, SET_CONTRAST);
-  ssd1306_command(ssd, 0xFF);
-  ssd1306_command(ssd, SET_ENTIRE_ON);
-  ssd1306_command(ssd, SET_NORM_INV);
-  ssd1306_command(ssd, SET_CHARGE_PUMP);
-  ssd1306_command(ssd, 0x14);
-  ssd1306_command(ssd, SET_DISP | 0x01);
+  const uint8_t commands[] = {
+    SET_DISP | 0x00,
+    SET_MEM_ADDR, 0x01,
+    SET_DISP_START_LINE | 0x00,
+    SET_SEG_REMAP | 0x01,
+    SET_MUX_RATIO, HEIGHT - 1,
+    SET_COM_OUT_DIR | 0x08,
+    SET_DISP_OFFSET, 0x00,
+    SET_COM_PIN_CFG, 0x12,
+    SET_DISP_CLK_DIV, 0x80,
+    SET_PRECHARGE, 0xF1,
+    SET_VCOM_DESEL, 0x30,
+    SET_CONTRAST, 0xFF,
+    SET_ENTIRE_ON,
+    SET_NORM_INV,
+    SET_CHARGE_PUMP, 0x14,
+    SET_DISP | 0x01,
+  };
+  ssd1306_commands(ssd, commands, sizeof(commands));
+}
+
+// Abre um trecho no fim do fluxo; os bytes vão direto para ssd->stream
+static inline void ssd1306_segment_open(ssd1306_t *ssd, bool data) {
+  ssd1306_segment_t *seg = &ssd->segments[ssd->num_segments++];
+  seg->offset = (uint16_t)ssd->stream_len;
+  seg->data = data;
+}
+
+static inline void ssd1306_segment_close(ssd1306_t *ssd) {
+  ssd1306_segment_t *seg = &ssd->segments[ssd->num_segments - 1];
+  seg->len = (uint16_t)(ssd->stream_len - seg->offset);
+}
+
+static void ssd1306_bus_done(void *arg, bool ok);
+
+// Entrega o fluxo montado ao barramento (com ssd->busy já ligado)
+static void ssd1306_transfer(ssd1306_t *ssd) {
+  if (ssd->num_segments == 0) {
+    ssd1306_bus_done(ssd, true);
+    return;
+  }
+  ssd->bus->send(ssd->bus->ctx, ssd->stream, ssd->segments, ssd->num_segments, ssd1306_bus_done, ssd);
+}
+
+// Comandos em sequência numa só transação (bloqueante)
+void ssd1306_commands(ssd1306_t *ssd, const uint8_t *commands, size_t count) {
+  while (true) {
+    ssd1306_wait(ssd);
+    critical_section_enter_blocking(&ssd->lock);
+    if (!ssd->busy)
+      break;
+    critical_section_exit(&ssd->lock);
+  }
+  ssd->busy = true;
+  critical_section_exit(&ssd->lock);
+  ssd->sending_frame = false;
+  ssd->done = NULL;
+  ssd->stream_len = 0;
+  ssd->num_segments = 0;
+
+  ssd1306_segment_open(ssd, false);
+  memcpy(ssd->stream, commands, count);
+  ssd->stream_len = count;
+  ssd1306_segment_close(ssd);
+
+  ssd1306_transfer(ssd);
+  ssd1306_wait(ssd);
 }
 
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
-  ssd->port_buffer[1] = command;
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->port_buffer,
-    2,
-    false
-  );
+  ssd1306_commands(ssd, &command, 1);
 }
 
-void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
-  );
+static inline void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t x, uint8_t page) {
+  if (x < ssd->dirty_x0[page])
+    ssd->dirty_x0[page] = x;
+  if (x > ssd->dirty_x1[page])
+    ssd->dirty_x1[page] = x;
 }
 
-void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
-  uint16_t index = (y >> 3) + (x << 3) + 1;
-  uint8_t pixel = (y & 0b111);
-  if (value)
-    ssd->ram_buffer[index] |= (1 << pixel);
-  else
-    ssd->ram_buffer[index] &= ~(1 << pixel);
+// Marca a tela inteira para ser enviada na próxima atualização
+void ssd1306_invalidate(ssd1306_t *ssd) {
+  for (uint8_t p = 0; p < ssd->pages; ++p) {
+    ssd->dirty_x0[p] = 0;
+    ssd->dirty_x1[p] = ssd->width - 1;
+  }
+  ssd->full_refresh = true;
 }
 
-/*
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
+// Monta uma janela (colunas x0..x1, páginas p0..p1) do front: um trecho com
+// os 6 comandos de endereçamento e outro com os dados. Em endereçamento
+// vertical o controlador espera os bytes coluna a coluna, que é a mesma
+// ordem do buffer; só é preciso recortar as páginas de cada coluna.
+static uint32_t ssd1306_emit_window(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1) {
+  const uint8_t commands[6] = { SET_COL_ADDR, x0, x1, SET_PAGE_ADDR, p0, p1 };
+  uint8_t npages = p1 - p0 + 1;
+  size_t start = ssd->stream_len;
 
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
+  ssd1306_segment_open(ssd, false);
+  memcpy(&ssd->stream[ssd->stream_len], commands, sizeof(commands));
+  ssd->stream_len += sizeof(commands);
+  ssd1306_segment_close(ssd);
+
+  ssd1306_segment_open(ssd, true);
+  for (uint16_t x = x0; x <= x1; ++x) {
+    const uint8_t *src = &ssd->front_buffer[(x << 3) + p0 + 1];
+    memcpy(&ssd->shadow_buffer[(x << 3) + p0 + 1], src, npages);
+    memcpy(&ssd->stream[ssd->stream_len], src, npages);
+    ssd->stream_len += npages;
+  }
+  ssd1306_segment_close(ssd);
+
+  return (uint32_t)(ssd->stream_len - start);
+}
+
+// Descarta das pontas da faixa pendente as colunas que, apesar de
+// desenhadas (ex.: fill seguido do mesmo texto), ficaram iguais ao que o
+// painel já tem
+static void ssd1306_trim_dirty(ssd1306_t *ssd, uint8_t page) {
+  uint8_t x0 = ssd->front_x0[page];
+  uint8_t x1 = ssd->front_x1[page];
+  const uint8_t *front = &ssd->front_buffer[page + 1];
+  const uint8_t *shadow = &ssd->shadow_buffer[page + 1];
+
+  while (x0 <= x1 && front[x0 << 3] == shadow[x0 << 3])
+    ++x0;
+  while (x1 > x0 && front[x1 << 3] == shadow[x1 << 3])
+    --x1;
+  if (x0 > x1) {
+    ssd->front_x0[page] = 0xFF;
+    ssd->front_x1[page] = 0;
+  } else {
+    ssd->front_x0[page] = x0;
+    ssd->front_x1[page] = x1;
+  }
+}
+
+// Monta o envio das regiões do front ainda não enviadas (com o lock).
+// Páginas consecutivas com alterações viram uma única janela com a união
+// das colunas. O fluxo é uma cópia, então o front pode receber o próximo
+// frame assim que isto retorna.
+static void ssd1306_build_frame(ssd1306_t *ssd) {
+  uint32_t bytes = 0;
+  uint8_t windows = 0;
+  uint8_t p = 0;
+
+  ssd->sending_frame = true;
+  ssd->send_start_us = time_us_32();
+  ssd->stream_len = 0;
+  ssd->num_segments = 0;
+
+  for (uint8_t page = 0; page < ssd->pages && !ssd->full_refresh; ++page) {
+    if (ssd->front_x0[page] <= ssd->front_x1[page])
+      ssd1306_trim_dirty(ssd, page);
+  }
+
+  while (p < ssd->pages) {
+    if (ssd->front_x0[p] > ssd->front_x1[p]) {
+      ++p;
+      continue;
+    }
+
+    uint8_t p0 = p;
+    uint8_t x0 = ssd->front_x0[p];
+    uint8_t x1 = ssd->front_x1[p];
+    while (p + 1 < ssd->pages && ssd->front_x0[p + 1] <= ssd->front_x1[p + 1]) {
+      ++p;
+      if (ssd->front_x0[p] < x0) x0 = ssd->front_x0[p];
+      if (ssd->front_x1[p] > x1) x1 = ssd->front_x1[p];
+    }
+
+    bytes += ssd1306_emit_window(ssd, x0, x1, p0, p);
+    ++windows;
+    ++p;
+  }
+
+  ssd1306_clear_dirty(ssd->front_x0, ssd->front_x1, ssd->pages);
+  ssd->full_refresh = false;
+  ssd->stats.frames++;
+  ssd->stats.last_frame_bytes = bytes;
+  ssd->stats.last_frame_windows = windows;
+  ssd->stats.last_frame_segments = ssd->num_segments;
+  ssd->stats.total_bytes += bytes;
+}
+
+// Fim de uma transferência (em geral em interrupção). Se um frame foi
+// publicado nesse meio tempo, ele já começa a sair. Um envio interrompido
+// deixa a sombra sem valor: o front inteiro volta a ser pendente e o
+// próximo frame sai completo, como depois de ssd1306_invalidate.
+static void ssd1306_bus_done(void *arg, bool ok) {
+  ssd1306_t *ssd = arg;
+  ssd1306_done_cb_t done = ssd->done;
+  void *ctx = ssd->done_ctx;
+  bool next;
+
+  if (!ok) {
+    ssd->stats.errors++;
+    critical_section_enter_blocking(&ssd->lock);
+    for (uint8_t p = 0; p < ssd->pages; ++p) {
+      ssd->front_x0[p] = 0;
+      ssd->front_x1[p] = ssd->width - 1;
     }
+    ssd->full_refresh = true;
+    critical_section_exit(&ssd->lock);
+  }
+
+  if (ssd->sending_frame) {
+    uint32_t us = time_us_32() - ssd->send_start_us;
+    ssd->stats.last_frame_us = us;
+    ssd->stats.total_us += us;
+    if (us > ssd->stats.max_frame_us)
+      ssd->stats.max_frame_us = us;
+  }
+
+  critical_section_enter_blocking(&ssd->lock);
+  next = ssd->pending;
+  if (next) {
+    ssd->pending = false;
+    ssd->done = ssd->next_done;
+    ssd->done_ctx = ssd->next_done_ctx;
+    ssd1306_build_frame(ssd);
+  } else {
+    ssd->busy = false;
+  }
+  critical_section_exit(&ssd->lock);
+
+  if (done)
+    done(ssd, ctx);
+  if (next)
+    ssd1306_transfer(ssd);
 }
 
+// Publica o back buffer como um frame completo: as colunas alteradas
+// passam para o front de uma vez, com o lock, então o envio nunca vê um
+// frame pela metade. Com o barramento livre o envio começa na hora;
+// senão o frame fica pendente e sai assim que o atual terminar (frames
+// publicados nesse meio tempo se juntam e só o último aparece). O back
+// continua com o conteúdo publicado e pode ser redesenhado logo em
+// seguida, enquanto o front transmite. 'done' roda quando o frame chega ao
+// painel, normalmente em contexto de interrupção. Retorna false se o frame
+// ficou pendente.
+bool ssd1306_swap(ssd1306_t *ssd, ssd1306_done_cb_t done, void *ctx) {
+  bool start;
 
+  critical_section_enter_blocking(&ssd->lock);
+  for (uint8_t p = 0; p < ssd->pages; ++p) {
+    uint8_t x0 = ssd->dirty_x0[p];
+    uint8_t x1 = ssd->dirty_x1[p];
+    if (x0 > x1)
+      continue;
+    for (uint16_t x = x0; x <= x1; ++x)
+      ssd->front_buffer[(x << 3) + p + 1] = ssd->ram_buffer[(x << 3) + p + 1];
+    if (x0 < ssd->front_x0[p])
+      ssd->front_x0[p] = x0;
+    if (x1 > ssd->front_x1[p])
+      ssd->front_x1[p] = x1;
+  }
+  ssd1306_clear_dirty(ssd->dirty_x0, ssd->dirty_x1, ssd->pages);
 
-void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
+  start = !ssd->busy;
+  if (start) {
+    ssd->busy = true;
+    ssd->done = done;
+    ssd->done_ctx = ctx;
+    ssd1306_build_frame(ssd);
+  } else {
+    ssd->pending = true;
+    ssd->next_done = done;
+    ssd->next_done_ctx = ctx;
   }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
+  critical_section_exit(&ssd->lock);
+
+  if (start)
+    ssd1306_transfer(ssd);
+  return start;
+}
+
+bool ssd1306_busy(ssd1306_t *ssd) {
+  return ssd->busy;
+}
+
+void ssd1306_wait(ssd1306_t *ssd) {
+  while (ssd->busy)
+    tight_loop_contents();
+}
+
+// Versão bloqueante: publica e espera o painel receber
+void ssd1306_send_data(ssd1306_t *ssd) {
+  ssd1306_swap(ssd, NULL, NULL);
+  ssd1306_wait(ssd);
+}
+
+// Substitui os bits de 'mask' do byte (coluna x, página page) por 'bits'
+static inline void ssd1306_put_bits(ssd1306_t *ssd, uint8_t x, uint8_t page, uint8_t mask, uint8_t bits) {
+  uint8_t *byte = &ssd->ram_buffer[(x << 3) + page + 1];
+  uint8_t value = (*byte & ~mask) | (bits & mask);
+  if (value != *byte) {
+    *byte = value;
+    ssd1306_mark_dirty(ssd, x, page);
   }
+}
+
+void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  uint8_t pixel = 1 << (y & 0b111);
+  ssd1306_put_bits(ssd, x, y >> 3, pixel, value ? pixel : 0);
+}
+
+void ssd1306_fill(ssd1306_t *ssd, bool value) {
+  memset(&ssd->ram_buffer[1], value ? 0xFF : 0x00, ssd->bufsize - 1);
+  // O envio compara com o painel e descarta o que não mudou
+  for (uint8_t p = 0; p < ssd->pages; ++p) {
+    ssd->dirty_x0[p] = 0;
+    ssd->dirty_x1[p] = ssd->width - 1;
+  }
+}
+
+// Copia uma imagem pronta no formato do ram_buffer (x * 8 + página, sem o
+// byte de controle); como no fill, o envio descarta o que não mudou
+void ssd1306_blit(ssd1306_t *ssd, const uint8_t *image) {
+  memcpy(&ssd->ram_buffer[1], image, ssd->bufsize - 1);
+  for (uint8_t p = 0; p < ssd->pages; ++p) {
+    ssd->dirty_x0[p] = 0;
+    ssd->dirty_x1[p] = ssd->width - 1;
+  }
+}
+
+void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+  if (width == 0 || height == 0)
+    return;
+  uint8_t right = left + width - 1;
+  uint8_t bottom = top + height - 1;
 
   if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
-      }
-    }
+    for (uint16_t x = left; x <= right && x < ssd->width; ++x)
+      ssd1306_vline(ssd, x, top, bottom, value);
+    return;
   }
+
+  ssd1306_hline(ssd, left, right, top, value);
+  ssd1306_hline(ssd, left, right, bottom, value);
+  ssd1306_vline(ssd, left, top, bottom, value);
+  ssd1306_vline(ssd, right, top, bottom, value);
 }
 
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+    // Linhas retas usam os caminhos por byte
+    if (y0 == y1) {
+        ssd1306_hline(ssd, x0 < x1 ? x0 : x1, x0 < x1 ? x1 : x0, y0, value);
+        return;
+    }
+    if (x0 == x1) {
+        ssd1306_vline(ssd, x0, y0 < y1 ? y0 : y1, y0 < y1 ? y1 : y0, value);
+        return;
+    }
+
     int dx = abs(x1 - x0);
     int dy = abs(y1 - y0);
 
@@ -144,16 +435,38 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 
 
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  if (y >= ssd->height)
+    return;
+  if (x1 >= ssd->width)
+    x1 = ssd->width - 1;
+  uint8_t pixel = 1 << (y & 0b111);
+  for (uint16_t x = x0; x <= x1; ++x)
+    ssd1306_put_bits(ssd, x, y >> 3, pixel, value ? pixel : 0);
 }
 
+// Escreve a coluna página a página: no máximo duas máscaras parciais
+// (início e fim) e bytes inteiros no meio
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  if (x >= ssd->width || y0 > y1 || y0 >= ssd->height)
+    return;
+  if (y1 >= ssd->height)
+    y1 = ssd->height - 1;
+
+  uint8_t bits = value ? 0xFF : 0x00;
+  for (uint8_t page = y0 >> 3; page <= (y1 >> 3); ++page) {
+    uint8_t mask = 0xFF;
+    if (page == (y0 >> 3))
+      mask &= 0xFF << (y0 & 0b111);
+    if (page == (y1 >> 3))
+      mask &= 0xFF >> (7 - (y1 & 0b111));
+    ssd1306_put_bits(ssd, x, page, mask, bits);
+  }
 }
 
 // Função para desenhar um caractere
+// A fonte é coluna a coluna com o bit 0 no topo, igual às páginas do
+// controlador: com y múltiplo de 8 cada coluna do glifo é um byte do buffer;
+// fora disso o byte se divide entre duas páginas.
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
 {
   uint16_t index = 0;
@@ -169,14 +482,20 @@ void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
     index = 0; // Índice 0 corresponde ao caractere "nada" (espaço)
   }
 
+  if (y >= ssd->height)
+    return;
+
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 0b111;
+  bool split = shift != 0 && page + 1 < ssd->pages;
+
   // Desenha o caractere na tela
-  for (uint8_t i = 0; i < 8; ++i)
+  for (uint8_t i = 0; i < 8 && x + i < ssd->width; ++i)
   {
-    uint8_t line = font[index + i]; // Acessa a linha correspondente do caractere na fonte
-    for (uint8_t j = 0; j < 8; ++j)
-    {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j)); // Desenha cada pixel do caractere
-    }
+    uint8_t line = font[index + i]; // Coluna do caractere na fonte
+    ssd1306_put_bits(ssd, x + i, page, 0xFF << shift, line << shift);
+    if (split)
+      ssd1306_put_bits(ssd, x + i, page + 1, 0xFF >> (8 - shift), line >> (8 - shift));
   }
 }
 
@@ -1,9 +1,19 @@
+#ifndef SSD1306_H
+#define SSD1306_H
+
 #include <stdlib.h>
 #include "pico/stdlib.h"
-#include "hardware/i2c.h"
+#include "pico/critical_section.h"
 
 #define WIDTH 128
 #define HEIGHT 64
+#define SSD1306_MAX_PAGES 8
+
+// Fluxo de um frame: dados de todas as páginas mais os 6 bytes de comando
+// de cada janela. Cada janela tem um trecho de comandos e um de dados.
+#define SSD1306_STREAM_MAX(bufsize) ((bufsize) + SSD1306_MAX_PAGES * 6)
+#define SSD1306_MAX_SEGMENTS (2 * SSD1306_MAX_PAGES)
+#define SSD1306_BUFSIZE (WIDTH * HEIGHT / 8 + 1)
 
 typedef enum {
   SET_CONTRAST = 0x81,
@@ -25,25 +35,101 @@ typedef enum {
   SET_CHARGE_PUMP = 0x8D
 } ssd1306_command_t;
 
+// Contadores de tráfego do barramento (bytes de comando + dados, sem o
+// endereçamento de cada transação) por atualização e tempo de cada envio, do
+// início do envio de um frame publicado ao fim da transferência
+typedef struct {
+  uint32_t frames;
+  uint32_t last_frame_bytes;
+  uint8_t last_frame_windows;
+  uint8_t last_frame_segments;
+  uint64_t total_bytes;
+  uint32_t last_frame_us;
+  uint32_t max_frame_us;
+  uint64_t total_us;
+  uint32_t errors;                       // Envios que o barramento não completou (ex.: NACK)
+} ssd1306_stats_t;
+
+typedef struct ssd1306 ssd1306_t;
+
+// Trecho do fluxo: uma sequência de comandos ou de dados, que o barramento
+// envia como uma transação (I2C: byte de controle 0x00 ou 0x40; SPI: D/C)
+typedef struct {
+  uint16_t offset;
+  uint16_t len;
+  bool data;
+} ssd1306_segment_t;
+
+// Barramento do painel. 'send' transmite os trechos em ordem, pode retornar
+// antes do fim e chama done(arg, ok) ao terminar (talvez em interrupção). O
+// fluxo e os trechos não mudam até lá. ok = false: o envio parou no meio e o
+// conteúdo do painel é desconhecido.
+typedef struct {
+  void (*send)(void *ctx, const uint8_t *stream, const ssd1306_segment_t *segments, uint8_t count,
+               void (*done)(void *arg, bool ok), void *arg);
+  void *ctx;
+} ssd1306_bus_t;
+
+// Memória de um display de até WIDTH x HEIGHT para ssd1306_init_static
 typedef struct {
-  uint8_t width, height, pages, address;
-  i2c_inst_t *i2c_port;
+  uint8_t ram[SSD1306_BUFSIZE];
+  uint8_t front[SSD1306_BUFSIZE];
+  uint8_t shadow[SSD1306_BUFSIZE];
+  uint8_t stream[SSD1306_STREAM_MAX(SSD1306_BUFSIZE)];
+} ssd1306_buffers_t;
+
+// Chamado ao fim de um envio assíncrono (em geral dentro de interrupção)
+typedef void (*ssd1306_done_cb_t)(ssd1306_t *ssd, void *ctx);
+
+struct ssd1306 {
+  uint8_t width, height, pages;
+  const ssd1306_bus_t *bus;
   bool external_vcc;
-  uint8_t *ram_buffer;
+  uint8_t *ram_buffer;                   // Back buffer: onde as primitivas desenham
   size_t bufsize;
-  uint8_t port_buffer[2];
-} ssd1306_t;
+  uint8_t *front_buffer;                 // Último frame publicado por ssd1306_swap
+  uint8_t *shadow_buffer;                // Cópia do que já está no painel
+  bool full_refresh;                     // Conteúdo do painel desconhecido: envia tudo
+  uint8_t dirty_x0[SSD1306_MAX_PAGES];   // Faixa de colunas alteradas em cada página do back
+  uint8_t dirty_x1[SSD1306_MAX_PAGES];   // (x0 > x1: página sem alterações)
+  uint8_t front_x0[SSD1306_MAX_PAGES];   // O mesmo para o front, ainda não enviado
+  uint8_t front_x1[SSD1306_MAX_PAGES];
+  ssd1306_stats_t stats;
+  uint32_t send_start_us;                // Início do envio em andamento
+  uint8_t *stream;                       // Comandos e dados do envio, lidos pelo barramento
+  size_t stream_len;
+  ssd1306_segment_t segments[SSD1306_MAX_SEGMENTS];
+  uint8_t num_segments;
+  bool sending_frame;                    // O envio em andamento é um frame (conta nas stats)
+  bool pending;                          // Frame publicado durante um envio: sai em seguida
+  critical_section_t lock;               // Front e envio (ssd1306_swap x fim da transferência)
+  volatile bool busy;
+  ssd1306_done_cb_t done;
+  void *done_ctx;
+  ssd1306_done_cb_t next_done;           // Callback do frame pendente
+  void *next_done_ctx;
+};
 
-void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
+void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, const ssd1306_bus_t *bus);
+void ssd1306_init_static(ssd1306_t *ssd, ssd1306_buffers_t *buffers, uint8_t width, uint8_t height, bool external_vcc,
+                         const ssd1306_bus_t *bus);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
+void ssd1306_commands(ssd1306_t *ssd, const uint8_t *commands, size_t count);
 void ssd1306_send_data(ssd1306_t *ssd);
+bool ssd1306_swap(ssd1306_t *ssd, ssd1306_done_cb_t done, void *ctx);
+bool ssd1306_busy(ssd1306_t *ssd);
+void ssd1306_wait(ssd1306_t *ssd);
+void ssd1306_invalidate(ssd1306_t *ssd);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
+void ssd1306_blit(ssd1306_t *ssd, const uint8_t *image);
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill);
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value);
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
-void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
\ No newline at end of file
+void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+
+#endif
@@ -0,0 +1,167 @@
+#include <string.h>
+#include "ssd1306_i2c.h"
+
+#if PICO_ON_DEVICE
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+// Dono de cada canal de DMA e de cada bloco I2C, para os tratadores de
+// interrupção acharem o barramento
+static ssd1306_i2c_t *dma_owner[NUM_DMA_CHANNELS];
+static ssd1306_i2c_t *i2c_owner[NUM_I2CS];
+
+// Fim do envio, com sucesso ou não. Um abort (NACK, perda de arbitragem)
+// esvazia a FIFO e a mantém descartando escritas até a leitura do
+// IC_CLR_TX_ABRT; o DMA ainda em curso é cancelado.
+static void ssd1306_i2c_finish(ssd1306_i2c_t *bus, bool ok) {
+  i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+
+  hw->intr_mask = 0;
+  if (!ok) {
+    dma_channel_set_irq1_enabled(bus->dma_chan, false);   // RP2040-E13: o abort pode gerar IRQ
+    dma_channel_abort(bus->dma_chan);
+    dma_channel_acknowledge_irq1(bus->dma_chan);
+    dma_channel_set_irq1_enabled(bus->dma_chan, true);
+    (void)hw->clr_tx_abrt;
+    bus->aborts++;
+  }
+  if (bus->active) {
+    bus->active = false;
+    bus->done(bus->arg, ok);
+  }
+}
+
+static inline bool ssd1306_i2c_aborted(i2c_hw_t *hw) {
+  return hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+}
+
+// Último byte fora: FIFO vazia e o mestre parado (depois do STOP)
+static inline bool ssd1306_i2c_idle(i2c_hw_t *hw) {
+  return hw->txflr == 0 && !(hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS);
+}
+
+// Fim do DMA: o envio inteiro já está na FIFO do I2C, mas até 16 bytes ainda
+// vão sair. O fim de verdade vem pelo STOP_DET (ou TX_ABRT) do bloco I2C.
+static void ssd1306_i2c_dma_irq_handler(void) {
+  for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch) {
+    ssd1306_i2c_t *bus = dma_owner[ch];
+    if (!bus || !dma_channel_get_irq1_status(ch))
+      continue;
+    dma_channel_acknowledge_irq1(ch);
+    if (!bus->active)
+      continue;
+
+    i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+    (void)hw->clr_stop_det;           // STOPs das transações anteriores do mesmo envio
+    if (ssd1306_i2c_aborted(hw))
+      ssd1306_i2c_finish(bus, false);
+    else if (ssd1306_i2c_idle(hw))
+      ssd1306_i2c_finish(bus, true);
+    else
+      hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+  }
+}
+
+static void ssd1306_i2c_irq_handler(void) {
+  for (uint n = 0; n < NUM_I2CS; ++n) {
+    ssd1306_i2c_t *bus = i2c_owner[n];
+    if (!bus)
+      continue;
+
+    i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+    uint32_t stat = hw->intr_stat;
+    if (stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+      ssd1306_i2c_finish(bus, false);
+    } else if (stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+      (void)hw->clr_stop_det;
+      if (ssd1306_i2c_idle(hw))
+        ssd1306_i2c_finish(bus, true);
+    }
+  }
+}
+
+static void ssd1306_i2c_send(void *ctx, const uint8_t *stream, const ssd1306_segment_t *segments, uint8_t count,
+                             void (*done)(void *arg, bool ok), void *arg) {
+  ssd1306_i2c_t *bus = ctx;
+  i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+  size_t len = 0;
+
+  for (uint8_t s = 0; s < count; ++s) {
+    const uint8_t *src = &stream[segments[s].offset];
+    bus->words[len++] = segments[s].data ? 0x40 : 0x00;
+    for (uint16_t i = 0; i < segments[s].len; ++i)
+      bus->words[len++] = src[i];
+    bus->words[len - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+  }
+  bus->done = done;
+  bus->arg = arg;
+
+  // Abort que ninguém tratou (ex.: depois do último envio): sem limpar, a
+  // FIFO descartaria este envio inteiro em silêncio
+  if (ssd1306_i2c_aborted(hw)) {
+    (void)hw->clr_tx_abrt;
+    bus->aborts++;
+    done(arg, false);
+    return;
+  }
+
+  // O endereço do escravo só pode mudar com o bloco I2C parado
+  if (hw->tar != bus->address) {
+    while (hw->status & I2C_IC_STATUS_ACTIVITY_BITS)
+      tight_loop_contents();
+    hw->enable = 0;
+    hw->tar = bus->address;
+    hw->enable = 1;
+  }
+  bus->active = true;
+  hw->intr_mask = I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+  dma_channel_transfer_from_buffer_now(bus->dma_chan, bus->words, len);
+}
+#else
+static void ssd1306_i2c_send(void *ctx, const uint8_t *stream, const ssd1306_segment_t *segments, uint8_t count,
+                             void (*done)(void *arg, bool ok), void *arg) {
+  ssd1306_i2c_t *bus = ctx;
+
+  for (uint8_t s = 0; s < count; ++s) {
+    bus->tx[0] = segments[s].data ? 0x40 : 0x00;
+    memcpy(&bus->tx[1], &stream[segments[s].offset], segments[s].len);
+    if (i2c_write_blocking(bus->i2c, bus->address, bus->tx, segments[s].len + 1, false) < 0) {
+      bus->aborts++;
+      done(arg, false);
+      return;
+    }
+  }
+  done(arg, true);
+}
+#endif
+
+const ssd1306_bus_t *ssd1306_i2c_init(ssd1306_i2c_t *bus, i2c_inst_t *i2c, uint8_t address, uint baudrate) {
+  bus->i2c = i2c;
+  bus->address = address;
+  bus->bus.send = ssd1306_i2c_send;
+  bus->bus.ctx = bus;
+  bus->aborts = 0;
+  i2c_init(i2c, baudrate);
+
+#if PICO_ON_DEVICE
+  bus->dma_chan = dma_claim_unused_channel(true);
+  dma_channel_config c = dma_channel_get_default_config(bus->dma_chan);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+  channel_config_set_read_increment(&c, true);
+  channel_config_set_write_increment(&c, false);
+  channel_config_set_dreq(&c, i2c_get_dreq(i2c, true));
+  dma_channel_configure(bus->dma_chan, &c, &i2c_get_hw(i2c)->data_cmd, bus->words, 0, false);
+
+  dma_owner[bus->dma_chan] = bus;
+  dma_channel_set_irq1_enabled(bus->dma_chan, true);
+  irq_add_shared_handler(DMA_IRQ_1, ssd1306_i2c_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+  irq_set_enabled(DMA_IRQ_1, true);
+
+  uint index = i2c_hw_index(i2c);
+  i2c_owner[index] = bus;
+  i2c_get_hw(i2c)->intr_mask = 0;
+  irq_add_shared_handler(I2C0_IRQ + index, ssd1306_i2c_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+  irq_set_enabled(I2C0_IRQ + index, true);
+#endif
+  return &bus->bus;
+}
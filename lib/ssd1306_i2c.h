@@ -0,0 +1,38 @@
+#ifndef SSD1306_I2C_H
+#define SSD1306_I2C_H
+
+// Barramento I2C do SSD1306: cada trecho vira uma transação com o byte de
+// controle na frente (0x00 = comandos em sequência, 0x40 = dados). Na placa o
+// envio inteiro sai por DMA direto para o IC_DATA_CMD, com STOP no último
+// byte de cada transação, e termina no STOP final ou num TX_ABRT (NACK),
+// que cancela o DMA e faz o próximo frame sair completo; no host, por
+// i2c_write_blocking.
+
+#include "hardware/i2c.h"
+#include "ssd1306.h"
+
+// Fluxo de um frame mais um byte de controle por trecho
+#define SSD1306_I2C_WORDS (SSD1306_STREAM_MAX(SSD1306_BUFSIZE) + SSD1306_MAX_SEGMENTS)
+
+typedef struct {
+  ssd1306_bus_t bus;
+  i2c_inst_t *i2c;
+  uint8_t address;
+  void (*done)(void *arg, bool ok);
+  void *arg;
+  uint32_t aborts;                       // Envios interrompidos (NACK, arbitragem)
+#if PICO_ON_DEVICE
+  uint16_t words[SSD1306_I2C_WORDS];     // Palavras para o IC_DATA_CMD, lidas pelo DMA
+  int dma_chan;
+  volatile bool active;                  // Envio em curso, ainda sem done
+#else
+  uint8_t tx[SSD1306_BUFSIZE];           // Uma transação por vez
+#endif
+} ssd1306_i2c_t;
+
+// Inicializa o bloco I2C em 'baudrate' (400 kHz no modo rápido; 1 MHz no
+// rápido plus, se o painel e os pull-ups aguentarem) e devolve o barramento
+// para ssd1306_init. Os pinos continuam com quem chama.
+const ssd1306_bus_t *ssd1306_i2c_init(ssd1306_i2c_t *bus, i2c_inst_t *i2c, uint8_t address, uint baudrate);
+
+#endif
@@ -0,0 +1,32 @@
+#include "ssd1306_spi.h"
+
+static void ssd1306_spi_send(void *ctx, const uint8_t *stream, const ssd1306_segment_t *segments, uint8_t count,
+                             void (*done)(void *arg, bool ok), void *arg) {
+  ssd1306_spi_t *bus = ctx;
+
+  gpio_put(bus->cs, 0);
+  for (uint8_t s = 0; s < count; ++s) {
+    // spi_write_blocking só retorna com o último bit fora, então D/C pode mudar
+    gpio_put(bus->dc, segments[s].data);
+    spi_write_blocking(bus->spi, &stream[segments[s].offset], segments[s].len);
+  }
+  gpio_put(bus->cs, 1);
+  done(arg, true);
+}
+
+const ssd1306_bus_t *ssd1306_spi_init(ssd1306_spi_t *bus, spi_inst_t *spi, uint baudrate, uint dc, uint cs) {
+  bus->spi = spi;
+  bus->dc = dc;
+  bus->cs = cs;
+  bus->bus.send = ssd1306_spi_send;
+  bus->bus.ctx = bus;
+
+  spi_init(spi, baudrate);
+  spi_set_format(spi, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+  gpio_init(dc);
+  gpio_set_dir(dc, GPIO_OUT);
+  gpio_init(cs);
+  gpio_put(cs, 1);
+  gpio_set_dir(cs, GPIO_OUT);
+  return &bus->bus;
+}
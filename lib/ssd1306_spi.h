@@ -0,0 +1,21 @@
+#ifndef SSD1306_SPI_H
+#define SSD1306_SPI_H
+
+// Barramento SPI de 4 fios do SSD1306: o pino D/C separa comandos (0) de
+// dados (1), então não há byte de controle. O envio é bloqueante (a 10 MHz
+// um frame inteiro leva menos de 1 ms) e 'done' roda antes de send retornar.
+
+#include "hardware/spi.h"
+#include "ssd1306.h"
+
+typedef struct {
+  ssd1306_bus_t bus;
+  spi_inst_t *spi;
+  uint dc, cs;
+} ssd1306_spi_t;
+
+// Inicializa o bloco SPI em 'baudrate' (o SSD1306 aceita até 10 MHz) e os
+// pinos D/C e CS; SCK e MOSI continuam com quem chama
+const ssd1306_bus_t *ssd1306_spi_init(ssd1306_spi_t *bus, spi_inst_t *spi, uint baudrate, uint dc, uint cs);
+
+#endif
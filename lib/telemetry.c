@@ -0,0 +1,89 @@
+#include <string.h>
+
+#include "telemetry.h"
+
+void telemetry_init(telemetry_ring_t *ring) {
+    memset(ring->buf, 0, sizeof(ring->buf));
+    for (size_t i = 0; i < TELEMETRY_RING_SIZE; i++) {
+        atomic_store_explicit(&ring->ready[i], 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&ring->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->dropped, 0, memory_order_relaxed);
+    ring->sent = 0;
+}
+
+
+uint8_t telemetry_crc8(const void *data, size_t len) {
+    const uint8_t *p = data;
+    uint8_t crc = 0;
+
+    while (len--) {
+        crc ^= *p++;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+
+// Pode ser chamado de qualquer contexto, inclusive ISR. Nunca bloqueia: com
+// o anel cheio o registro é contado em 'dropped' e descartado.
+bool telemetry_push(telemetry_ring_t *ring, telemetry_type_t type, uint8_t a, uint8_t b, uint8_t c,
+                    uint32_t value, uint32_t timestamp_us) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    do {
+        uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (head - tail >= TELEMETRY_RING_SIZE) {
+            atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&ring->head, &head, head + 1,
+                                                    memory_order_acquire, memory_order_relaxed));
+
+    uint32_t i = head & TELEMETRY_RING_MASK;
+    ring->buf[i] = (telemetry_record_t){
+        .sync = TELEMETRY_SYNC,
+        .type = (uint8_t)type,
+        .seq = (uint16_t)head,
+        .timestamp_us = timestamp_us,
+        .a = a,
+        .b = b,
+        .c = c,
+        .value = value,
+    };
+    atomic_store_explicit(&ring->ready[i], 1, memory_order_release);
+    return true;
+}
+
+
+// Registros prontos e contíguos a partir de tail (até o fim do vetor). Ficam
+// no anel, com o CRC preenchido, até telemetry_release.
+size_t telemetry_peek(telemetry_ring_t *ring, const telemetry_record_t **records) {
+    uint32_t first = atomic_load_explicit(&ring->tail, memory_order_relaxed) & TELEMETRY_RING_MASK;
+    size_t n = 0;
+
+    while (first + n < TELEMETRY_RING_SIZE &&
+           atomic_load_explicit(&ring->ready[first + n], memory_order_acquire)) {
+        telemetry_record_t *r = &ring->buf[first + n];
+        r->crc = 0;
+        r->crc = telemetry_crc8(r, sizeof(*r));
+        n++;
+    }
+    *records = &ring->buf[first];
+    return n;
+}
+
+
+// Devolve ao anel os 'n' registros já enviados
+void telemetry_release(telemetry_ring_t *ring, size_t n) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    for (size_t i = 0; i < n; i++) {
+        atomic_store_explicit(&ring->ready[(tail + i) & TELEMETRY_RING_MASK], 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&ring->tail, tail + (uint32_t)n, memory_order_release);
+    ring->sent += n;
+}
@@ -0,0 +1,70 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+// Anel de telemetria binária: registros de 16 bytes já no formato do fio,
+// escritos sem lock por vários produtores (ISR e tarefas) e lidos por um só
+// consumidor, que os entrega ao transporte direto do anel, sem cópia.
+//
+// O produtor reserva uma posição com compare-and-swap em head, preenche o
+// registro e então marca ready[] (release). O consumidor só avança até o
+// primeiro registro não marcado, então um produtor interrompido no meio da
+// escrita segura os seguintes mas nunca deixa sair um registro incompleto.
+// O CRC é calculado pelo consumidor, fora da ISR.
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TELEMETRY_RING_SIZE 256             // Potência de 2
+#define TELEMETRY_RING_MASK (TELEMETRY_RING_SIZE - 1)
+#define TELEMETRY_SYNC 0xA5                 // Primeiro byte de todo registro
+
+typedef enum {
+    TELEMETRY_EVENT = 1,        // a: gpio, b: tipo do evento, c: aceito na fila
+    TELEMETRY_OCCUPANCY = 2,    // a: chave, b: delta (int8), c: 1 se valor absoluto; value: estado
+    TELEMETRY_LATENCY = 3,      // a: gpio; value: us
+    TELEMETRY_COUNTER = 4,      // a: id do contador; value: valor acumulado
+} telemetry_type_t;
+
+// Little-endian, sem preenchimento
+typedef struct {
+    uint8_t sync;
+    uint8_t type;
+    uint16_t seq;               // Posição no anel: buracos indicam perdas no transporte
+    uint32_t timestamp_us;
+    uint8_t a;
+    uint8_t b;
+    uint8_t c;
+    uint8_t crc;                // CRC-8 (0x07) do registro com este campo em 0
+    uint32_t value;
+} telemetry_record_t;
+
+_Static_assert(sizeof(telemetry_record_t) == 16, "registro de telemetria precisa de 16 bytes");
+
+typedef struct {
+    telemetry_record_t buf[TELEMETRY_RING_SIZE];
+    _Atomic uint8_t ready[TELEMETRY_RING_SIZE];
+    _Atomic uint32_t head;                  // Próxima posição a reservar (produtores)
+    _Atomic uint32_t tail;                  // Próximo registro a enviar (consumidor)
+    _Atomic uint32_t dropped;               // Recusados com o anel cheio
+    uint32_t sent;
+} telemetry_ring_t;
+
+void telemetry_init(telemetry_ring_t *ring);
+bool telemetry_push(telemetry_ring_t *ring, telemetry_type_t type, uint8_t a, uint8_t b, uint8_t c,
+                    uint32_t value, uint32_t timestamp_us);
+size_t telemetry_peek(telemetry_ring_t *ring, const telemetry_record_t **records);
+void telemetry_release(telemetry_ring_t *ring, size_t n);
+uint8_t telemetry_crc8(const void *data, size_t len);
+
+static inline size_t telemetry_count(telemetry_ring_t *ring) {
+    return atomic_load_explicit(&ring->head, memory_order_acquire) -
+           atomic_load_explicit(&ring->tail, memory_order_acquire);
+}
+
+static inline uint32_t telemetry_dropped(telemetry_ring_t *ring) {
+    return atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+}
+
+#endif
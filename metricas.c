@@ -0,0 +1,165 @@
+/*
+ *  Instrumentação em produção.
+ *
+ *  Os ganchos TRACE_EVENTO_* alimentam um histograma logarítmico por botão
+ *  (cada botão é tratado por uma só tarefa, então os contadores têm um só
+ *  escritor). Uma tarefa de prioridade mínima lê o stdio e, ao receber
+ *  METRICAS_TECLA, imprime o relatório.
+ */
+
+#include "controle_vaga.h"
+
+typedef struct {
+    uint gpio;
+    uint32_t aceitos, descartados, tratados;
+    uint32_t max_us;
+    uint64_t soma_us;
+    uint32_t faixas[METRICAS_FAIXAS];
+} metricas_botao_t;
+
+static metricas_botao_t botoes[METRICAS_MAX_BOTOES];
+static uint8_t num_botoes;
+static int8_t botao_do_gpio[32];
+// Saída do vTaskGetRunTimeStatistics: as tarefas registradas mais as do
+// kernel e das bibliotecas (ociosas, timers, lwIP), como em alocacao.c
+static char texto_tarefas[METRICAS_LINHA_TAREFA * (ALOCACAO_MAX_TAREFAS + 4)];
+
+static void vTaskMetricas(void *params);
+
+
+void metricas_init(void) {
+    for (size_t i = 0; i < count_of(botao_do_gpio); i++) {
+        botao_do_gpio[i] = -1;
+    }
+    TaskHandle_t tarefa;
+    CRIA_TAREFA(tarefa, vTaskMetricas, "MetricasTask", configMINIMAL_STACK_SIZE + 256, tskIDLE_PRIORITY);
+}
+
+
+// Os botões ganham uma entrada na primeira borda (sempre na ISR)
+static metricas_botao_t *metricas_botao(uint gpio, bool cria) {
+    if (gpio >= count_of(botao_do_gpio)) {
+        return NULL;
+    }
+    if (botao_do_gpio[gpio] < 0) {
+        if (!cria || num_botoes == METRICAS_MAX_BOTOES) {
+            return NULL;
+        }
+        botoes[num_botoes].gpio = gpio;
+        botao_do_gpio[gpio] = (int8_t)num_botoes++;
+    }
+    return &botoes[botao_do_gpio[gpio]];
+}
+
+
+void metricas_evento_isr(uint gpio, bool aceito) {
+    metricas_botao_t *b = metricas_botao(gpio, true);
+    if (!b) return;
+
+    if (aceito) {
+        b->aceitos++;
+    } else {
+        b->descartados++;
+    }
+}
+
+
+// Latência da entrada na ISR até a tarefa acordar e pegar o evento
+void metricas_evento_tarefa(uint gpio, uint32_t irq_us) {
+    metricas_botao_t *b = metricas_botao(gpio, false);
+    if (!b) return;
+
+    uint32_t us = time_us_32() - irq_us;
+    uint faixa = us ? 32 - __builtin_clz(us) : 0;
+    if (faixa >= METRICAS_FAIXAS) faixa = METRICAS_FAIXAS - 1;
+
+    b->faixas[faixa]++;
+    b->tratados++;
+    b->soma_us += us;
+    if (us > b->max_us) b->max_us = us;
+}
+
+
+// Limite superior da faixa que contém o percentil p
+static uint32_t metricas_percentil(const metricas_botao_t *b, uint32_t p) {
+    uint32_t alvo = (b->tratados * p + 99) / 100;
+    uint32_t acumulado = 0;
+
+    for (uint i = 0; i < METRICAS_FAIXAS; i++) {
+        acumulado += b->faixas[i];
+        if (acumulado >= alvo) {
+            return 1u << i;
+        }
+    }
+    return b->max_us;
+}
+
+
+void metricas_relatorio(void) {
+    display_stats_t render;
+    buzzer_stats_t buzzer;
+    journal_stats_t journal;
+    const ssd1306_stats_t *oled = display_ssd_stats();
+
+    display_stats(&render);
+    buzzer_get_stats(&buzzer);
+    controle_vaga_journal_stats(&journal);
+
+    printf("\n== metricas: %.1f s ==\n", time_us_64() / 1e6);
+#if configGENERATE_RUN_TIME_STATS
+    vTaskGetRunTimeStatistics(texto_tarefas, sizeof(texto_tarefas));     // Corta o que não couber
+    printf("tarefa\t\ttempo (us)\t%%\n%s", texto_tarefas);
+#endif
+    for (uint i = 0; i < num_botoes; i++) {
+        const metricas_botao_t *b = &botoes[i];
+        printf("gpio %2u: %lu tratados, %lu descartados, media %lu us, p50<%lu p90<%lu p99<%lu max %lu us\n",
+               b->gpio, (unsigned long)b->tratados, (unsigned long)b->descartados,
+               (unsigned long)(b->tratados ? b->soma_us / b->tratados : 0),
+               (unsigned long)metricas_percentil(b, 50), (unsigned long)metricas_percentil(b, 90),
+               (unsigned long)metricas_percentil(b, 99), (unsigned long)b->max_us);
+        printf("  faixas:");
+        for (uint f = 0; f < METRICAS_FAIXAS; f++) {
+            if (b->faixas[f]) printf(" <%lu:%lu", (unsigned long)(1u << f), (unsigned long)b->faixas[f]);
+        }
+        printf("\n");
+    }
+    printf("descartados: %lu\n", (unsigned long)eventos_descartados);
+#if CONTROLE_VAGA_BAIXO_CONSUMO
+    baixo_consumo_stats_t bc;
+    baixo_consumo_stats(&bc);
+    printf("dormant: %lu vezes, despertar -> evento tratado media %lu us, ultimo %lu us, max %lu us\n",
+           (unsigned long)bc.dormencias, (unsigned long)(bc.medidas ? bc.soma_latencia_us / bc.medidas : 0),
+           (unsigned long)bc.ultima_latencia_us, (unsigned long)bc.max_latencia_us);
+#endif
+    printf("display: %lu envios, %lu erros, media %lu us, max %lu us, %lu bytes/envio; %lu pedidos, %lu coalescidos\n",
+           (unsigned long)oled->frames, (unsigned long)oled->errors,
+           (unsigned long)(oled->frames ? oled->total_us / oled->frames : 0),
+           (unsigned long)oled->max_frame_us,
+           (unsigned long)(oled->frames ? oled->total_bytes / oled->frames : 0),
+           (unsigned long)render.pedidos, (unsigned long)render.coalescidos);
+    printf("buzzer: %lu tocados, %lu interrompidos, %lu descartados, alarmes %llu us (max %lu us), bloqueado %llu us\n",
+           (unsigned long)buzzer.played, (unsigned long)buzzer.preempted, (unsigned long)buzzer.dropped,
+           (unsigned long long)buzzer.callback_us, (unsigned long)buzzer.callback_max_us,
+           (unsigned long long)buzzer.blocking_us);
+    printf("journal: %lu gravados em %lu commits, %lu descartados, %lu devolvidos, %lu erros, %lu apagamentos\n",
+           (unsigned long)journal.committed, (unsigned long)journal.commits, (unsigned long)journal.dropped,
+           (unsigned long)journal.requeued, (unsigned long)journal.errors, (unsigned long)journal.erases);
+    alocacao_relatorio();
+}
+
+
+// Sem entrada no stdio a tarefa só acorda a cada METRICAS_POLL_MS
+static void vTaskMetricas(void *params) {
+    while (true) {
+        int c = getchar_timeout_us(0);
+        if (c == METRICAS_TECLA) {
+            metricas_relatorio();
+#if CONTROLE_VAGA_ANALISE
+        } else if (c == ANALISE_TECLA) {
+            analise_relatorio();
+#endif
+        } else if (c == PICO_ERROR_TIMEOUT) {
+            vTaskDelay(pdMS_TO_TICKS(METRICAS_POLL_MS));
+        }
+    }
+}
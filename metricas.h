@@ -0,0 +1,25 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+// Modo de instrumentação (CONTROLE_VAGA_METRICAS): histogramas de latência
+// ISR -> tarefa por botão, tempo de CPU por tarefa (run-time stats do
+// FreeRTOS sobre o timer de 1 MHz) e tempo gasto no display e no buzzer.
+// O relatório sai pela USB quando chega METRICAS_TECLA no stdio.
+
+#include "pico/stdlib.h"
+
+#define METRICAS_MAX_BOTOES 8
+#define METRICAS_FAIXAS 20          // Faixa i: latência em [2^(i-1), 2^i) us; a última acumula o resto
+#define METRICAS_TECLA 'm'
+#define METRICAS_POLL_MS 100        // Intervalo de leitura do stdio
+#define METRICAS_LINHA_TAREFA 48    // Nome, contador e % de uma tarefa no vTaskGetRunTimeStatistics
+
+void metricas_init(void);
+void metricas_evento_isr(uint gpio, bool aceito);
+void metricas_evento_tarefa(uint gpio, uint32_t irq_us);
+void metricas_relatorio(void);
+
+#define TRACE_EVENTO_ISR(gpio, aceito) metricas_evento_isr((gpio), (aceito))
+#define TRACE_EVENTO_TAREFA(gpio, irq_us) metricas_evento_tarefa((gpio), (irq_us))
+
+#endif
@@ -0,0 +1,166 @@
+/*
+ *  Snapshot da ocupação servido pela rede.
+ *
+ *  A RedeTask acorda quando o estado muda, espera REDE_LOTE_MS para juntar
+ *  as mudanças seguidas e formata a resposta num dos dois buffers: o corpo
+ *  JSON primeiro, depois o cabeçalho (que precisa do tamanho do corpo) logo
+ *  antes dele. Só a troca do buffer publicado acontece com a trava do
+ *  transporte, a mesma que os callbacks de rede seguram enquanto enviam.
+ *  Assim nenhum envio vê um buffer pela metade e formatar não segura a
+ *  pilha de rede. O buffer que não está publicado é só desta tarefa.
+ */
+
+#include <string.h>
+
+#include "controle_vaga.h"
+
+typedef struct {
+    char texto[REDE_SNAPSHOT];
+    size_t inicio;                  // Começo do cabeçalho HTTP
+    size_t fim;
+} snapshot_t;
+
+static snapshot_t snapshots[2];
+static uint8_t publicado;
+static rede_stats_t stats;
+static TaskHandle_t xTaskRede;
+
+static const char resposta_404[] =
+    "HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+
+static void vTaskRede(void *params);
+
+
+void rede_init(void) {
+    CRIA_TAREFA(xTaskRede, vTaskRede, "RedeTask", REDE_PILHA, tskIDLE_PRIORITY + 1);
+#if CONTROLE_VAGA_SMP
+    vTaskCoreAffinitySet(xTaskRede, 1 << NUCLEO_IO);
+#endif
+}
+
+
+// Chamado pelas tarefas de eventos a cada mudança de ocupação ou de fila
+// (nada acontece sem rede_init, como nos outros benchmarks do host)
+void rede_mudou(void) {
+    if (xTaskRede) xTaskNotifyGive(xTaskRede);
+}
+
+
+// Corpo JSON a partir de REDE_CABECALHO; devolve o fim ou 0 se não coube
+static size_t formata_corpo(char *texto) {
+    char *p = texto + REDE_CABECALHO;
+    char *fim = texto + REDE_SNAPSHOT;
+    uint16_t capacidade;
+    uint16_t ocupadas = estacionamento_total(&capacidade);
+    int n;
+
+    n = snprintf(p, fim - p, "{\"versao\":%lu,\"gerado_ms\":%lu,\"ocupadas\":%u,\"capacidade\":%u,\"lotes\":[",
+                 (unsigned long)stats.versao + 1, (unsigned long)(time_us_64() / 1000u), ocupadas, capacidade);
+    if (n < 0 || n >= fim - p) return 0;
+    p += n;
+
+    for (size_t i = 0; i < estacionamento_num_lotes(); i++) {
+        lote_resumo_t lote;
+        admissao_resumo_t fila;
+        estacionamento_resumo(i, &lote);
+        admissao_resumo(i, &fila);
+
+        n = snprintf(p, fim - p, "%s{\"nome\":\"%s\",\"ocupadas\":%u,\"capacidade\":%u,\"fila\":%u,\"recusas\":%lu}",
+                     i ? "," : "", lote.nome, lote.ocupadas, lote.capacidade, fila.tamanho,
+                     (unsigned long)lote.recusas);
+        if (n < 0 || n >= fim - p) return 0;
+        p += n;
+    }
+
+    n = snprintf(p, fim - p, "]}\n");
+    if (n < 0 || n >= fim - p) return 0;
+    return p + n - texto;
+}
+
+
+// Refaz o buffer livre e o publica
+static void reconstroi(void) {
+    snapshot_t *s = &snapshots[publicado ^ 1];
+    char cabecalho[REDE_CABECALHO];
+    size_t fim = formata_corpo(s->texto);
+
+    if (fim == 0) {
+        printf("Snapshot da rede não cabe em %u bytes!\n", REDE_SNAPSHOT);
+        return;
+    }
+    int n = snprintf(cabecalho, sizeof(cabecalho),
+                     "HTTP/1.0 200 OK\r\nContent-Type: application/json\r\nContent-Length: %u\r\n"
+                     "Cache-Control: no-cache\r\nConnection: close\r\n\r\n",
+                     (unsigned)(fim - REDE_CABECALHO));
+    s->inicio = REDE_CABECALHO - n;
+    s->fim = fim;
+    memcpy(s->texto + s->inicio, cabecalho, n);
+
+    rede_trava();
+    publicado ^= 1;
+    stats.versao++;
+    rede_destrava();
+}
+
+
+// "GET / " e "GET /status" (com ou sem parâmetros) recebem o snapshot
+static bool pede_status(const char *pedido, size_t n) {
+    static const char prefixo[] = "GET /";
+    const size_t tam = sizeof(prefixo) - 1;
+
+    if (n < tam + 1 || memcmp(pedido, prefixo, tam) != 0) {
+        return false;
+    }
+    pedido += tam;
+    n -= tam;
+    if (n >= 6 && memcmp(pedido, "status", 6) == 0) {
+        pedido += 6;
+        n -= 6;
+    }
+    return n > 0 && (*pedido == ' ' || *pedido == '?');
+}
+
+
+const char *rede_resposta_http(const char *pedido, size_t n, size_t *tamanho) {
+    if (!pede_status(pedido, n)) {
+        stats.nao_encontrado++;
+        *tamanho = sizeof(resposta_404) - 1;
+        return resposta_404;
+    }
+    const snapshot_t *s = &snapshots[publicado];
+    stats.http++;
+    *tamanho = s->fim - s->inicio;
+    return s->texto + s->inicio;
+}
+
+
+// O datagrama de resposta leva só o JSON
+const char *rede_resposta_udp(size_t *tamanho) {
+    const snapshot_t *s = &snapshots[publicado];
+    stats.udp++;
+    *tamanho = s->fim - REDE_CABECALHO;
+    return s->texto + REDE_CABECALHO;
+}
+
+
+void rede_stats(rede_stats_t *out) {
+    rede_trava();
+    *out = stats;
+    rede_destrava();
+}
+
+
+// Publica o primeiro snapshot antes de abrir as portas; na placa a conexão
+// ao Wi-Fi pode levar vários segundos e as mudanças ficam na notificação
+static void vTaskRede(void *params) {
+    reconstroi();
+    while (!rede_transporte_inicia()) {
+        vTaskDelay(pdMS_TO_TICKS(REDE_WIFI_TENTATIVA_MS));
+    }
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        vTaskDelay(pdMS_TO_TICKS(REDE_LOTE_MS));
+        ulTaskNotifyTake(pdTRUE, 0);
+        reconstroi();
+    }
+}
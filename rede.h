@@ -0,0 +1,53 @@
+#ifndef REDE_H
+#define REDE_H
+
+// Status da ocupação pela rede (CONTROLE_VAGA_REDE): um GET HTTP ou qualquer
+// datagrama UDP recebe um JSON com a ocupação de cada lote. A resposta HTTP
+// inteira (cabeçalho e corpo) fica pronta num buffer que só é refeito
+// quando o estado muda, então atender um cliente é só enviar o buffer.
+//
+// O transporte é a API raw do lwIP na Pico W (rede_lwip.c) e sockets BSD
+// no loopback no build do host (host/rede_host.c).
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef REDE_PORTA_HTTP
+#define REDE_PORTA_HTTP 80
+#endif
+#ifndef REDE_PORTA_UDP
+#define REDE_PORTA_UDP 4210
+#endif
+
+#define REDE_SNAPSHOT 1024          // Cabeçalho e JSON de até EST_MAX_LOTES lotes
+#define REDE_CABECALHO 160          // Espaço reservado antes do corpo
+#define REDE_LOTE_MS 100            // Espera para juntar mudanças numa só reconstrução
+#define REDE_PILHA (configMINIMAL_STACK_SIZE + 256)
+#define REDE_WIFI_TIMEOUT_MS 30000
+#define REDE_WIFI_TENTATIVA_MS 5000 // Intervalo entre tentativas de conexão
+
+typedef struct {
+    uint32_t versao;                // Reconstruções do snapshot
+    uint32_t http;                  // Respostas 200
+    uint32_t nao_encontrado;        // Respostas 404
+    uint32_t udp;
+} rede_stats_t;
+
+void rede_init(void);
+void rede_mudou(void);
+void rede_stats(rede_stats_t *out);
+
+// Chamadas pelo transporte com rede_trava ativa. O ponteiro vale até
+// rede_destrava.
+const char *rede_resposta_http(const char *pedido, size_t n, size_t *tamanho);
+const char *rede_resposta_udp(size_t *tamanho);
+
+// Implementadas pelo transporte
+bool rede_transporte_inicia(void);
+void rede_trava(void);
+void rede_destrava(void);
+
+#define REDE_MUDOU() rede_mudou()
+
+#endif
@@ -0,0 +1,142 @@
+/*
+ *  Transporte do status pela API raw do lwIP (Pico W).
+ *
+ *  Os callbacks rodam na thread do lwIP com a trava do núcleo da pilha, a
+ *  mesma que cyw43_arch_lwip_begin pega, então a resposta pode ser lida
+ *  direto do snapshot publicado. O TCP copia o buffer para os próprios
+ *  segmentos (TCP_WRITE_FLAG_COPY) e fecha a conexão logo depois: o FIN
+ *  sai depois dos dados. Não há estado por conexão.
+ */
+
+#include "pico/cyw43_arch.h"
+
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/tcp.h"
+#include "lwip/udp.h"
+
+#include "controle_vaga.h"
+
+#define REDE_PEDIDO 32              // Basta a linha "GET /status "
+
+static bool wifi_pronto;            // cyw43_arch_init feito
+static bool conectado;
+
+
+void rede_trava(void) {
+    if (wifi_pronto) cyw43_arch_lwip_begin();
+}
+
+void rede_destrava(void) {
+    if (wifi_pronto) cyw43_arch_lwip_end();
+}
+
+
+static err_t http_fecha(struct tcp_pcb *pcb) {
+    tcp_recv(pcb, NULL);
+    if (tcp_close(pcb) != ERR_OK) {
+        tcp_abort(pcb);
+        return ERR_ABRT;
+    }
+    return ERR_OK;
+}
+
+
+// Responde ao primeiro segmento do pedido e fecha
+static err_t http_recebe(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
+    char pedido[REDE_PEDIDO];
+    size_t tamanho;
+
+    if (p == NULL) {
+        return http_fecha(pcb);
+    }
+    u16_t n = pbuf_copy_partial(p, pedido, sizeof(pedido), 0);
+    tcp_recved(pcb, p->tot_len);
+    pbuf_free(p);
+
+    const char *resposta = rede_resposta_http(pedido, n, &tamanho);
+    if (tcp_write(pcb, resposta, tamanho, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+        tcp_abort(pcb);
+        return ERR_ABRT;
+    }
+    tcp_output(pcb);
+    return http_fecha(pcb);
+}
+
+
+static err_t http_aceita(void *arg, struct tcp_pcb *pcb, err_t err) {
+    if (err != ERR_OK || pcb == NULL) {
+        return ERR_VAL;
+    }
+    tcp_recv(pcb, http_recebe);
+    return ERR_OK;
+}
+
+
+// Qualquer datagrama na porta recebe o JSON de volta
+static void udp_recebe(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *origem, u16_t porta) {
+    size_t tamanho;
+    const char *corpo = rede_resposta_udp(&tamanho);
+
+    pbuf_free(p);
+    struct pbuf *resposta = pbuf_alloc(PBUF_TRANSPORT, tamanho, PBUF_RAM);
+    if (resposta == NULL) {
+        return;
+    }
+    pbuf_take(resposta, corpo, tamanho);
+    udp_sendto(pcb, resposta, origem, porta);
+    pbuf_free(resposta);
+}
+
+
+static bool abre_portas(void) {
+    struct tcp_pcb *tcp = tcp_new_ip_type(IPADDR_TYPE_ANY);
+    struct udp_pcb *udp = udp_new_ip_type(IPADDR_TYPE_ANY);
+    struct tcp_pcb *escuta = NULL;
+
+    if (tcp && udp && tcp_bind(tcp, IP_ANY_TYPE, REDE_PORTA_HTTP) == ERR_OK &&
+        udp_bind(udp, IP_ANY_TYPE, REDE_PORTA_UDP) == ERR_OK) {
+        escuta = tcp_listen_with_backlog(tcp, 2);   // Libera o pcb original
+    }
+    if (escuta == NULL) {
+        if (tcp) tcp_close(tcp);
+        if (udp) udp_remove(udp);
+        return false;
+    }
+    tcp_accept(escuta, http_aceita);
+    udp_recv(udp, udp_recebe, NULL);
+    return true;
+}
+
+
+// Roda na RedeTask: o cyw43_arch com FreeRTOS precisa do escalonador ativo.
+// Falso faz a tarefa tentar de novo depois de REDE_WIFI_TENTATIVA_MS.
+bool rede_transporte_inicia(void) {
+    if (!wifi_pronto) {
+        if (cyw43_arch_init() != 0) {
+            printf("Wi-Fi indisponível!\n");
+            return false;
+        }
+        cyw43_arch_enable_sta_mode();
+        wifi_pronto = true;
+    }
+    if (!conectado) {
+        if (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_SENHA, CYW43_AUTH_WPA2_AES_PSK,
+                                               REDE_WIFI_TIMEOUT_MS) != 0) {
+            printf("Sem conexão com a rede %s\n", WIFI_SSID);
+            return false;
+        }
+        conectado = true;
+    }
+
+    cyw43_arch_lwip_begin();
+    bool ok = abre_portas();
+    cyw43_arch_lwip_end();
+    if (!ok) {
+        printf("Portas do status indisponíveis!\n");
+        return false;
+    }
+    printf("Status em http://%s:%u/status e udp %u\n", ip4addr_ntoa(netif_ip4_addr(netif_default)),
+           REDE_PORTA_HTTP, REDE_PORTA_UDP);
+    return true;
+}
@@ -0,0 +1,99 @@
+/*
+ *  Telemetria binária pela USB.
+ *
+ *  Os produtores só reservam uma posição no anel e escrevem 16 bytes, então
+ *  os ganchos cabem na ISR dos botões. A TelemetriaTask, com a menor
+ *  prioridade, entrega os registros prontos ao driver da USB em blocos,
+ *  direto da memória do anel, sem passar pelo printf nem pela conversão de
+ *  fim de linha do stdio. Texto do printf pode aparecer entre os blocos; o
+ *  decodificador se ressincroniza pelo byte TELEMETRY_SYNC e pelo CRC.
+ */
+
+#include "pico/stdio_usb.h"
+
+#include "controle_vaga.h"
+
+static telemetry_ring_t anel;
+
+static void vTaskTelemetria(void *params);
+
+
+void telemetria_init(void) {
+    telemetry_init(&anel);
+
+    TaskHandle_t tarefa;
+    CRIA_TAREFA(tarefa, vTaskTelemetria, "TelemetriaTask", TELEMETRIA_PILHA, tskIDLE_PRIORITY);
+#if CONTROLE_VAGA_SMP
+    vTaskCoreAffinitySet(tarefa, 1 << NUCLEO_IO);
+#endif
+}
+
+
+// Chamado pela ISR com o instante da borda
+void telemetria_evento(uint gpio, uint8_t tipo, bool aceito, uint32_t timestamp_us) {
+    telemetry_push(&anel, TELEMETRY_EVENT, (uint8_t)gpio, tipo, aceito, 0, timestamp_us);
+}
+
+
+// delta 0: valor absoluto (reset)
+void telemetria_ocupacao(uint8_t lote, int8_t delta, uint16_t ocupadas) {
+    telemetry_push(&anel, TELEMETRY_OCCUPANCY, lote, (uint8_t)delta, delta == 0, ocupadas, time_us_32());
+}
+
+
+void telemetria_latencia(uint gpio, uint32_t irq_us) {
+    uint32_t agora = time_us_32();
+    telemetry_push(&anel, TELEMETRY_LATENCY, (uint8_t)gpio, 0, 0, agora - irq_us, agora);
+}
+
+
+static void contador(contador_t id, uint32_t valor, uint32_t agora) {
+    telemetry_push(&anel, TELEMETRY_COUNTER, id, 0, 0, valor, agora);
+}
+
+static void registra_contadores(void) {
+    uint32_t agora = time_us_32();
+    uint16_t capacidade;
+    uint32_t fila = 0;
+    display_stats_t render;
+
+    display_stats(&render);
+    for (size_t i = 0; i < estacionamento_num_lotes(); i++) {
+        admissao_resumo_t resumo;
+        admissao_resumo((uint8_t)i, &resumo);
+        fila += resumo.tamanho;
+    }
+    contador(CONTADOR_DESCARTADOS, eventos_descartados, agora);
+    contador(CONTADOR_TELEMETRIA_PERDIDOS, telemetry_dropped(&anel), agora);
+    contador(CONTADOR_TELEMETRIA_ENVIADOS, anel.sent, agora);
+    contador(CONTADOR_FRAMES, render.frames, agora);
+    contador(CONTADOR_OCUPADAS, estacionamento_total(&capacidade), agora);
+    contador(CONTADOR_FILA_ADMISSAO, fila, agora);
+}
+
+
+// Envia os registros prontos: no máximo dois blocos por volta do anel
+static void envia_pendentes(void) {
+    const telemetry_record_t *registros;
+    size_t n;
+
+    while ((n = telemetry_peek(&anel, &registros)) > 0) {
+        stdio_usb.out_chars((const char *)registros, (int)(n * sizeof(telemetry_record_t)));
+        telemetry_release(&anel, n);
+    }
+}
+
+
+static void vTaskTelemetria(void *params) {
+    TickType_t ultimo = xTaskGetTickCount();
+    TickType_t ultimos_contadores = ultimo;
+
+    while (true) {
+        vTaskDelayUntil(&ultimo, pdMS_TO_TICKS(TELEMETRIA_PERIODO_MS));
+        if (xTaskGetTickCount() - ultimos_contadores >= pdMS_TO_TICKS(TELEMETRIA_CONTADORES_MS)) {
+            ultimos_contadores = xTaskGetTickCount();
+            registra_contadores();
+        }
+        envia_pendentes();
+    }
+}
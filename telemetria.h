@@ -0,0 +1,37 @@
+#ifndef TELEMETRIA_H
+#define TELEMETRIA_H
+
+// Telemetria binária pela USB (CONTROLE_VAGA_TELEMETRIA): eventos das ISRs,
+// mudanças de ocupação, latência ISR -> tarefa e contadores periódicos viram
+// registros de 16 bytes (lib/telemetry.h). Uma tarefa de prioridade mínima
+// envia o anel em blocos direto ao driver da USB; tools/telemetria_csv.py
+// converte a captura em CSV.
+
+#include "pico/stdlib.h"
+#include "lib/telemetry.h"
+
+#define TELEMETRIA_PERIODO_MS 20        // Intervalo entre envios
+#define TELEMETRIA_CONTADORES_MS 1000   // Intervalo entre registros de contadores
+#define TELEMETRIA_PILHA (configMINIMAL_STACK_SIZE + 128)
+
+// Ids dos registros TELEMETRY_COUNTER (mesma ordem no decodificador)
+typedef enum {
+    CONTADOR_DESCARTADOS,           // Fila de eventos cheia
+    CONTADOR_TELEMETRIA_PERDIDOS,   // Anel de telemetria cheio
+    CONTADOR_TELEMETRIA_ENVIADOS,
+    CONTADOR_FRAMES,                // Telas desenhadas
+    CONTADOR_OCUPADAS,              // Soma de todos os lotes
+    CONTADOR_FILA_ADMISSAO,         // Carros esperando em todos os lotes
+} contador_t;
+
+void telemetria_init(void);
+void telemetria_evento(uint gpio, uint8_t tipo, bool aceito, uint32_t timestamp_us);
+void telemetria_ocupacao(uint8_t lote, int8_t delta, uint16_t ocupadas);
+void telemetria_latencia(uint gpio, uint32_t irq_us);
+
+#define TELEMETRIA_EVENTO(gpio, tipo, aceito, timestamp_us) \
+    telemetria_evento((gpio), (tipo), (aceito), (timestamp_us))
+#define TELEMETRIA_OCUPACAO(lote, delta, ocupadas) telemetria_ocupacao((lote), (delta), (ocupadas))
+#define TELEMETRIA_LATENCIA(gpio, irq_us) telemetria_latencia((gpio), (irq_us))
+
+#endif
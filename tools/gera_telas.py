@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""
+Gera as telas fixas do display já rasterizadas, no formato do ram_buffer do
+SSD1306 (endereçamento vertical: byte x * 8 + página), a partir da fonte de
+lib/font.h. Mostrar uma tela vira uma cópia; só os campos dinâmicos (nomes
+dos lotes e contadores) são desenhados em tempo de execução.
+
+Uso: gera_telas.py lib/font.h saida/telas.h
+"""
+
+import re
+import sys
+
+LARGURA = 128
+ALTURA = 64
+PAGINAS = ALTURA // 8
+
+# Textos fixos de cada tela: (texto, x, y), desenhados em ordem como o
+# ssd1306_draw_string faria sobre a tela apagada
+TELAS = {
+    "tela_espera": [("Aguardando...", 5, 2)],
+    "tela_entrada": [("Evento ", 5, 10), ("recebido!", 5, 19), ("Eventos:", 5, 44)],
+    "tela_saida": [("Saida!", 5, 10), ("Eventos:", 5, 44)],
+    "tela_reset": [("Contador ", 5, 10), ("resetado!", 5, 19)],
+    "tela_fila": [("Lote cheio!", 5, 10), ("Fila:", 5, 44), ("Espera:", 5, 54)],
+    "tela_analise": [("Ultima hora", 5, 2)],
+}
+
+# Posição dos campos desenhados em tempo de execução
+CAMPOS = {
+    "LOTES": (5, 16),       # Uma linha por lote, a cada 10 pixels (tela de espera)
+    "LOTE": (5, 34),        # Nome do lote do evento
+    "EVENTOS": (5 + 8 * len("Eventos: "), 44),  # Ocupadas/capacidade após o rótulo
+    "POSICAO": (5 + 8 * len("Fila: "), 44),     # Posição na fila de admissão
+    "ESPERA": (5 + 8 * len("Espera: "), 54),    # Espera estimada
+    "VAGA": (5, 54),        # Vaga atribuída na entrada (texto inteiro, só quando há vaga)
+    "MEDIAS": (5, 12),      # Médias de 15 e 60 minutos (página de estatísticas)
+    "GRAFICO": (4, 24),     # Uma barra de 2 pixels por minuto até o fim da tela
+}
+
+
+def le_fonte(caminho):
+    with open(caminho, encoding="utf-8") as f:
+        texto = f.read()
+    corpo = texto[texto.index("{") + 1:texto.rindex("}")]
+    # Os comentários de cada linha (o próprio caractere) não têm "0x"
+    corpo = re.sub(r"//.*", "", corpo)
+    fonte = [int(b, 16) for b in re.findall(r"0x[0-9A-Fa-f]{2}", corpo)]
+    if len(fonte) != 8 * (ord("~") - ord(" ") + 1):
+        sys.exit(f"{caminho}: esperava 95 glifos de 8 bytes, li {len(fonte)} bytes")
+    return fonte
+
+
+def poe_bits(img, x, pagina, mascara, bits):
+    i = x * PAGINAS + pagina
+    img[i] = (img[i] & ~mascara & 0xFF) | (bits & mascara & 0xFF)
+
+
+# Mesmo resultado do ssd1306_draw_char: a faixa de 8 linhas é sobrescrita
+def desenha_char(img, fonte, c, x, y):
+    indice = (ord(c) - ord(" ")) * 8 if " " <= c <= "~" else 0
+    if y >= ALTURA:
+        return
+    pagina, desvio = y >> 3, y & 7
+    dividido = desvio != 0 and pagina + 1 < PAGINAS
+    for i in range(8):
+        if x + i >= LARGURA:
+            break
+        linha = fonte[indice + i]
+        poe_bits(img, x + i, pagina, 0xFF << desvio, linha << desvio)
+        if dividido:
+            poe_bits(img, x + i, pagina + 1, 0xFF >> (8 - desvio), linha >> (8 - desvio))
+
+
+# Mesma quebra de linha do ssd1306_draw_string
+def desenha_texto(img, fonte, texto, x, y):
+    for c in texto:
+        desenha_char(img, fonte, c, x, y)
+        x += 8
+        if x + 8 >= LARGURA:
+            x, y = 0, y + 8
+        if y + 8 >= ALTURA:
+            break
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    fonte = le_fonte(sys.argv[1])
+
+    linhas = [
+        "// Gerado por tools/gera_telas.py a partir de lib/font.h. Não edite.",
+        "#ifndef TELAS_H",
+        "#define TELAS_H",
+        "",
+        "#include <stdint.h>",
+        "",
+        f"#define TELA_BYTES {LARGURA * ALTURA // 8}",
+        "",
+    ]
+    for nome, (x, y) in CAMPOS.items():
+        linhas.append(f"#define TELA_{nome}_X {x}")
+        linhas.append(f"#define TELA_{nome}_Y {y}")
+    for nome, textos in TELAS.items():
+        img = bytearray(LARGURA * ALTURA // 8)
+        for texto, x, y in textos:
+            desenha_texto(img, fonte, texto, x, y)
+        linhas.append("")
+        linhas.append("// " + " / ".join(t.strip() for t, _, _ in textos))
+        linhas.append(f"static const uint8_t {nome}[TELA_BYTES] = {{")
+        for i in range(0, len(img), 16):
+            linhas.append("    " + ", ".join(f"0x{b:02X}" for b in img[i:i + 16]) + ",")
+        linhas.append("};")
+    linhas += ["", "#endif", ""]
+
+    with open(sys.argv[2], "w", encoding="utf-8") as f:
+        f.write("\n".join(linhas))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+"""
+Converte a telemetria binária do firmware (CONTROLE_VAGA_TELEMETRIA) em CSV.
+
+Os registros têm 16 bytes (lib/telemetry.h): sync 0xA5, tipo, seq, instante
+em us, três campos de um byte, CRC-8 e um valor de 32 bits, little-endian.
+O texto do printf que aparece entre os blocos é ignorado: a leitura procura
+o byte de sync e só aceita registros com CRC válido.
+
+Uso: telemetria_csv.py /dev/ttyACM0|captura.bin [saida.csv]
+
+Com um terminal serial a porta é posta em modo bruto e a leitura segue até
+Ctrl-C. As sequências que faltam (perdas no transporte) saem no stderr.
+"""
+
+import csv
+import os
+import struct
+import sys
+
+SYNC = 0xA5
+TAMANHO = 16
+FORMATO = struct.Struct("<BBHIBBBBI")
+
+EVENTO, OCUPACAO, LATENCIA, CONTADOR = 1, 2, 3, 4
+TIPOS_EVENTO = ["entrada", "saida", "reset"]        # tipo_evento_t
+CONTADORES = [                                      # contador_t em telemetria.h
+    "descartados",
+    "telemetria_perdidos",
+    "telemetria_enviados",
+    "frames",
+    "ocupadas",
+    "fila_admissao",
+]
+
+
+def crc8(dados):
+    crc = 0
+    for b in dados:
+        crc ^= b
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def registro_valido(bloco):
+    if bloco[0] != SYNC or not EVENTO <= bloco[1] <= CONTADOR:
+        return False
+    sem_crc = bytearray(bloco)
+    sem_crc[11] = 0
+    return crc8(sem_crc) == bloco[11]
+
+
+def descreve(tipo, a, b, c, valor):
+    """(tipo, id, detalhe, valor) de cada linha do CSV"""
+    if tipo == EVENTO:
+        nome = TIPOS_EVENTO[b] if b < len(TIPOS_EVENTO) else str(b)
+        return "evento", a, nome if c else nome + " descartado", c
+    if tipo == OCUPACAO:
+        delta = b - 256 if b >= 128 else b
+        return "ocupacao", a, "=" if c else f"{delta:+d}", valor
+    if tipo == LATENCIA:
+        return "latencia", a, "", valor
+    nome = CONTADORES[a] if a < len(CONTADORES) else str(a)
+    return "contador", nome, "", valor
+
+
+class Decodificador:
+    def __init__(self, saida):
+        self.csv = csv.writer(saida)
+        self.csv.writerow(["seq", "timestamp_us", "tipo", "id", "detalhe", "valor"])
+        self.buffer = bytearray()
+        self.ultimo_seq = None
+        self.perdidos = 0
+        self.ignorados = 0
+        self.voltas = 0             # O instante de 32 bits volta a 0 a cada ~71 min
+        self.ultimo_ts = None
+
+    def alimenta(self, dados):
+        self.buffer += dados
+        inicio = 0
+        while True:
+            pos = self.buffer.find(bytes([SYNC]), inicio)
+            if pos < 0:
+                self.ignorados += len(self.buffer) - inicio
+                inicio = len(self.buffer)
+                break
+            self.ignorados += pos - inicio
+            if len(self.buffer) - pos < TAMANHO:
+                inicio = pos
+                break
+            bloco = bytes(self.buffer[pos:pos + TAMANHO])
+            if registro_valido(bloco):
+                self.escreve(bloco)
+                inicio = pos + TAMANHO
+            else:
+                self.ignorados += 1
+                inicio = pos + 1
+        del self.buffer[:inicio]
+
+    def escreve(self, bloco):
+        _, tipo, seq, ts, a, b, c, _, valor = FORMATO.unpack(bloco)
+        if self.ultimo_seq is not None and seq != (self.ultimo_seq + 1) & 0xFFFF:
+            self.perdidos += (seq - self.ultimo_seq - 1) & 0xFFFF
+        self.ultimo_seq = seq
+
+        # Registros de produtores diferentes chegam um pouco fora de ordem:
+        # só um salto para trás de mais de meia volta conta como volta
+        if self.ultimo_ts is not None and ts < self.ultimo_ts and self.ultimo_ts - ts > 1 << 31:
+            self.voltas += 1
+        self.ultimo_ts = ts
+
+        self.csv.writerow([seq, (self.voltas << 32) + ts, *descreve(tipo, a, b, c, valor)])
+
+
+def abre_entrada(caminho):
+    f = open(caminho, "rb", buffering=0)
+    if os.isatty(f.fileno()):
+        import tty
+        tty.setraw(f.fileno())
+    return f
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(2)
+
+    saida = open(sys.argv[2], "w", newline="", encoding="utf-8") if len(sys.argv) == 3 else sys.stdout
+    dec = Decodificador(saida)
+    with abre_entrada(sys.argv[1]) as entrada:
+        try:
+            while True:
+                dados = entrada.read(4096)
+                if not dados:
+                    break
+                dec.alimenta(dados)
+                saida.flush()
+        except KeyboardInterrupt:
+            pass
+
+    print(f"{dec.perdidos} registros perdidos no transporte, {dec.ignorados} bytes ignorados",
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
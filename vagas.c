@@ -0,0 +1,147 @@
+/*
+ *  Vagas de cada lote em mapas de bits.
+ *
+ *  As palavras de todos os lotes vêm de uma arena fixa dividida no init. A
+ *  vaga de cada carro também entra numa fila circular por lote: os sensores
+ *  de saída não dizem de qual vaga o carro saiu, então a saída libera a
+ *  vaga ocupada há mais tempo (o mesmo pareamento da análise de
+ *  permanência). Com um sensor por vaga bastaria liberar a vaga informada.
+ *
+ *  Ocupar, liberar e limpar não têm lock próprio: a admissão (admissao.c)
+ *  as chama com a trava do lote, a mesma com que muda o contador dele, então
+ *  o mapa tem sempre tantas vagas ocupadas quanto o contador e a vaga de uma
+ *  entrada aceita sempre existe. Lotes diferentes não compartilham trava. Cada uma custa três clz e no máximo três
+ *  escritas.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "lib/slot_bitmap.h"
+#include "vagas.h"
+
+#define PALAVRAS (SLOT_BITMAP_WORDS(VAGAS_MAX) + EST_MAX_LOTES)  // Uma parcial por lote
+#define RESUMOS (SLOT_BITMAP_SUMMARY(VAGAS_MAX) + EST_MAX_LOTES)
+
+typedef struct {
+    slot_bitmap_t mapa;
+    uint16_t *ordem;                // Vagas na ordem em que foram ocupadas
+    uint16_t cabeca;
+    uint16_t tamanho;
+    uint16_t por_nivel;
+    uint16_t por_zona;
+    uint8_t niveis;
+} vagas_lote_t;
+
+static uint32_t palavras[PALAVRAS];
+static uint32_t resumos[RESUMOS];
+static uint16_t ordens[VAGAS_MAX];
+static vagas_lote_t lotes_vagas[EST_MAX_LOTES];
+static size_t num_lotes;
+
+
+static uint16_t divide_acima(uint16_t a, uint16_t b) {
+    return (a + b - 1) / b;
+}
+
+
+// Divide a arena entre os lotes e marca como ocupadas as primeiras vagas de
+// cada um, tantas quanto a ocupação restaurada do journal
+bool vagas_init(const lote_cfg_t *lotes, size_t n_lotes) {
+    size_t p = 0, r = 0, o = 0;
+
+    for (size_t i = 0; i < n_lotes; i++) {
+        vagas_lote_t *v = &lotes_vagas[i];
+        uint16_t capacidade = lotes[i].capacidade;
+        uint8_t niveis = lotes[i].niveis ? lotes[i].niveis : 1;
+        uint8_t zonas = lotes[i].zonas ? lotes[i].zonas : 1;
+        lote_resumo_t resumo;
+
+        if (o + capacidade > VAGAS_MAX || zonas > 26 ||
+            !slot_bitmap_init(&v->mapa, &palavras[p], &resumos[r], capacidade)) {
+            return false;
+        }
+        p += SLOT_BITMAP_WORDS(capacidade);
+        r += SLOT_BITMAP_SUMMARY(capacidade);
+        v->ordem = &ordens[o];
+        o += capacidade;
+
+        v->niveis = niveis;
+        v->por_nivel = divide_acima(capacidade, niveis);
+        v->por_zona = divide_acima(v->por_nivel, zonas);
+
+        estacionamento_resumo(i, &resumo);
+        v->cabeca = 0;
+        v->tamanho = 0;
+        while (v->tamanho < resumo.ocupadas) {
+            v->ordem[v->tamanho++] = (uint16_t)slot_bitmap_alloc(&v->mapa);
+        }
+    }
+    num_lotes = n_lotes;
+    return true;
+}
+
+
+// Menor vaga livre do lote. Com a trava do lote, depois de
+// estacionamento_entra.
+int16_t vagas_ocupa(uint8_t lote) {
+    vagas_lote_t *v = &lotes_vagas[lote];
+    int32_t vaga = slot_bitmap_alloc(&v->mapa);
+
+    if (vaga == SLOT_BITMAP_NONE) {
+        return VAGAS_NENHUMA;
+    }
+    v->ordem[(v->cabeca + v->tamanho) % v->mapa.capacity] = (uint16_t)vaga;
+    v->tamanho++;
+    return (int16_t)vaga;
+}
+
+
+// Vaga ocupada há mais tempo. Com a trava do lote, junto com
+// estacionamento_sai.
+int16_t vagas_libera(uint8_t lote) {
+    vagas_lote_t *v = &lotes_vagas[lote];
+    int16_t vaga;
+
+    if (v->tamanho == 0) {
+        return VAGAS_NENHUMA;
+    }
+    vaga = (int16_t)v->ordem[v->cabeca];
+    v->cabeca = (v->cabeca + 1) % v->mapa.capacity;
+    v->tamanho--;
+    slot_bitmap_release(&v->mapa, (uint16_t)vaga);
+    return vaga;
+}
+
+
+// Reset: todas as vagas do lote livres (com a trava do lote)
+void vagas_limpa(uint8_t lote) {
+    vagas_lote_t *v = &lotes_vagas[lote];
+
+    slot_bitmap_clear(&v->mapa);
+    v->cabeca = 0;
+    v->tamanho = 0;
+}
+
+
+uint16_t vagas_livres(uint8_t lote) {
+    return (uint16_t)lotes_vagas[lote].mapa.free;
+}
+
+
+// "N2 B07": nível e zona só aparecem quando o lote tem mais de um
+void vagas_rotulo(uint8_t lote, int16_t vaga, char *buffer, size_t tamanho) {
+    const vagas_lote_t *v = &lotes_vagas[lote];
+    uint16_t nivel = vaga / v->por_nivel;
+    uint16_t no_nivel = vaga % v->por_nivel;
+    char zona = (char)('A' + no_nivel / v->por_zona);
+    uint16_t numero = no_nivel % v->por_zona + 1;
+
+    if (v->niveis > 1) {
+        snprintf(buffer, tamanho, "N%u %c%02u", nivel + 1, zona, numero);
+    } else if (v->por_zona < v->por_nivel) {
+        snprintf(buffer, tamanho, "%c%02u", zona, numero);
+    } else {
+        snprintf(buffer, tamanho, "%u", numero);
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef VAGAS_H
+#define VAGAS_H
+
+// Vaga de cada carro dentro do lote. Cada lote tem um mapa de bits de vagas
+// (lib/slot_bitmap.h) e a entrada recebe a menor vaga livre. As vagas são
+// numeradas por nível e zona (nível 1 zona A primeiro), então a menor livre
+// é a mais próxima da entrada. Ocupar e liberar custam o mesmo com 5 ou com
+// milhares de vagas. Só a admissão (admissao.c) ocupa, libera e limpa, na
+// mesma trava por lote com que muda a ocupação dele.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "estacionamento.h"
+
+#define VAGAS_MAX 4096              // Soma das capacidades de todos os lotes
+#define VAGAS_NENHUMA (-1)
+#define VAGAS_ROTULO 12             // "N12 C034" e o terminador
+
+bool vagas_init(const lote_cfg_t *lotes, size_t n_lotes);
+int16_t vagas_ocupa(uint8_t lote);
+int16_t vagas_libera(uint8_t lote);
+void vagas_limpa(uint8_t lote);
+uint16_t vagas_livres(uint8_t lote);
+void vagas_rotulo(uint8_t lote, int16_t vaga, char *buffer, size_t tamanho);
+
+#endif